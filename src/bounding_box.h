@@ -0,0 +1,125 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// Ограничивающий прямоугольник, стороны параллельны осям
+struct Bounding_Box {
+    double min_x{std::numeric_limits<double>::infinity()};
+    double min_y{std::numeric_limits<double>::infinity()};
+    double max_x{-std::numeric_limits<double>::infinity()};
+    double max_y{-std::numeric_limits<double>::infinity()};
+
+    void expand(double x, double y) {
+        min_x = std::min(min_x, x);
+        min_y = std::min(min_y, y);
+        max_x = std::max(max_x, x);
+        max_y = std::max(max_y, y);
+    }
+
+    bool empty() const { return min_x > max_x || min_y > max_y; }
+
+    bool intersects(const Bounding_Box& other) const {
+        return min_x <= other.max_x && other.min_x <= max_x &&
+               min_y <= other.max_y && other.min_y <= max_y;
+    }
+};
+
+// Габариты многих фигур, разложенные по отдельным массивам координат.
+// Проверка окна идёт сразу по нескольким прямоугольникам за инструкцию (SSE2/AVX).
+class Bounding_Box_Array {
+public:
+    size_t size() const { return min_x.size(); }
+
+    void resize(size_t n) {
+        Bounding_Box empty_box;
+        min_x.resize(n, empty_box.min_x);
+        min_y.resize(n, empty_box.min_y);
+        max_x.resize(n, empty_box.max_x);
+        max_y.resize(n, empty_box.max_y);
+    }
+
+    void clear() { resize(0); }
+
+    void set(size_t i, const Bounding_Box& box) {
+        min_x[i] = box.min_x;
+        min_y[i] = box.min_y;
+        max_x[i] = box.max_x;
+        max_y[i] = box.max_y;
+    }
+
+    Bounding_Box get(size_t i) const {
+        Bounding_Box box;
+        box.min_x = min_x[i];
+        box.min_y = min_y[i];
+        box.max_x = max_x[i];
+        box.max_y = max_y[i];
+        return box;
+    }
+
+    void erase(size_t i) {
+        min_x.erase(min_x.begin() + i);
+        min_y.erase(min_y.begin() + i);
+        max_x.erase(max_x.begin() + i);
+        max_y.erase(max_y.begin() + i);
+    }
+
+    // Индексы прямоугольников, пересекающих window, по возрастанию
+    std::vector<size_t> intersecting(const Bounding_Box& window) const {
+        std::vector<size_t> result;
+        const size_t n = size();
+        size_t i = 0;
+#if defined(__AVX__)
+        const __m256d w_max_x = _mm256_set1_pd(window.max_x);
+        const __m256d w_min_x = _mm256_set1_pd(window.min_x);
+        const __m256d w_max_y = _mm256_set1_pd(window.max_y);
+        const __m256d w_min_y = _mm256_set1_pd(window.min_y);
+        for (; i + 4 <= n; i += 4) {
+            __m256d hit = _mm256_and_pd(
+                _mm256_and_pd(_mm256_cmp_pd(_mm256_loadu_pd(&min_x[i]), w_max_x, _CMP_LE_OQ),
+                              _mm256_cmp_pd(_mm256_loadu_pd(&max_x[i]), w_min_x, _CMP_GE_OQ)),
+                _mm256_and_pd(_mm256_cmp_pd(_mm256_loadu_pd(&min_y[i]), w_max_y, _CMP_LE_OQ),
+                              _mm256_cmp_pd(_mm256_loadu_pd(&max_y[i]), w_min_y, _CMP_GE_OQ)));
+            int mask = _mm256_movemask_pd(hit);
+            for (int k = 0; mask != 0; ++k, mask >>= 1) {
+                if (mask & 1) result.push_back(i + k);
+            }
+        }
+#elif defined(__SSE2__)
+        const __m128d w_max_x = _mm_set1_pd(window.max_x);
+        const __m128d w_min_x = _mm_set1_pd(window.min_x);
+        const __m128d w_max_y = _mm_set1_pd(window.max_y);
+        const __m128d w_min_y = _mm_set1_pd(window.min_y);
+        for (; i + 2 <= n; i += 2) {
+            __m128d hit = _mm_and_pd(
+                _mm_and_pd(_mm_cmple_pd(_mm_loadu_pd(&min_x[i]), w_max_x),
+                           _mm_cmpge_pd(_mm_loadu_pd(&max_x[i]), w_min_x)),
+                _mm_and_pd(_mm_cmple_pd(_mm_loadu_pd(&min_y[i]), w_max_y),
+                           _mm_cmpge_pd(_mm_loadu_pd(&max_y[i]), w_min_y)));
+            int mask = _mm_movemask_pd(hit);
+            if (mask & 1) result.push_back(i);
+            if (mask & 2) result.push_back(i + 1);
+        }
+#endif
+        for (; i < n; ++i) {
+            if (min_x[i] <= window.max_x && max_x[i] >= window.min_x &&
+                min_y[i] <= window.max_y && max_y[i] >= window.min_y) {
+                result.push_back(i);
+            }
+        }
+        return result;
+    }
+
+private:
+    std::vector<double> min_x;
+    std::vector<double> min_y;
+    std::vector<double> max_x;
+    std::vector<double> max_y;
+};
@@ -1,16 +1,58 @@
 #pragma once
+#include <atomic>
+#include <cmath>
 #include <concepts>
+#include <cstddef>
+#include <cstdint>
 #include <iostream>
+#include <optional>
 #include <string_view>
-#include <string>
 #include <ostream>
 #include <memory>
 #include "point.h"
+#include "bounding_box.h"
+
+// Тип фигуры — один байт в каждом объекте вместо строки с названием
+enum class Figure_Kind : std::uint8_t {
+    triangle,
+    hexagon,
+    octagon,
+};
+
+inline constexpr size_t figure_kind_count = 3;
+
+inline constexpr std::string_view figure_kind_names[figure_kind_count] = {
+    "triangle",
+    "hexagon",
+    "octagon",
+};
+
+inline constexpr std::string_view kind_name(Figure_Kind kind) {
+    return figure_kind_names[static_cast<size_t>(kind)];
+}
+
+inline std::optional<Figure_Kind> kind_from_name(std::string_view name) {
+    for (size_t i = 0; i < figure_kind_count; ++i) {
+        if (figure_kind_names[i] == name) {
+            return static_cast<Figure_Kind>(i);
+        }
+    }
+    return std::nullopt;
+}
+
+// Метрики фигуры, посчитанные за один проход по вершинам
+struct Figure_Metrics {
+    double area{0};
+    double perimeter{0};
+    Point<double> center;    // среднее вершин, как geometric_center()
+    Point<double> centroid;  // центр масс многоугольника
+    Bounding_Box bounds;
+};
 
 template<Scalar T>
 class Figure {
     friend std::ostream& operator<<(std::ostream& os, const Figure& figure){
-        os << figure.description << ":\n";
+        os << figure.get_name() << ":\n";
         figure.print(os);
         return os;
     };
@@ -21,23 +63,78 @@ class Figure {
     };
 
 protected:
-    Figure() = default;
-    Figure(std::string_view description) : description(description) {}
+    explicit Figure(Figure_Kind kind) : kind(kind), revision(next_revision()) {}
+
+    // Наследники вызывают при любом изменении вершин
+    void touch() { revision = next_revision(); }
+
+    // Общая реализация metrics() для наследников с массивом вершин
+    template<size_t N>
+    static Figure_Metrics polygon_metrics(const std::unique_ptr<Point<T>> (&points)[N]) {
+        Figure_Metrics m;
+        double sum_x = 0, sum_y = 0, cx = 0, cy = 0, area2 = 0;
+        double x0 = points[N - 1]->get_x(), y0 = points[N - 1]->get_y();
+        for (size_t i = 0; i < N; ++i) {
+            double x1 = points[i]->get_x(), y1 = points[i]->get_y();
+            double cross = x0 * y1 - x1 * y0;
+            area2 += cross;
+            cx += (x0 + x1) * cross;
+            cy += (y0 + y1) * cross;
+            m.perimeter += std::sqrt((x1 - x0) * (x1 - x0) + (y1 - y0) * (y1 - y0));
+            sum_x += x1;
+            sum_y += y1;
+            m.bounds.expand(x1, y1);
+            x0 = x1;
+            y0 = y1;
+        }
+        m.area = std::abs(area2) * 0.5;
+        m.center = Point<double>(sum_x / N, sum_y / N);
+        m.centroid = (area2 != 0) ? Point<double>(cx / (3 * area2), cy / (3 * area2)) : m.center;
+        return m;
+    }
 
 public:
     virtual ~Figure() = default;
 
+    Figure_Kind get_kind() const { return kind; }
+    std::string_view get_name() const { return kind_name(kind); }
+
+    // Номер версии вершин: меняется при set_vertex, read и присваивании
+    std::uint32_t get_revision() const { return revision; }
+
     virtual void print(std::ostream& os) const = 0;
     virtual void read(std::istream& is) = 0;
 
-    virtual std::unique_ptr<Point<T>> geometric_center() const = 0;
+    // Геометрический центр по значению — без выделения памяти
+    virtual Point<T> center() const = 0;
+
+    virtual std::unique_ptr<Point<T>> geometric_center() const {
+        return std::make_unique<Point<T>>(center());
+    }
+
     virtual double square() const = 0;
     virtual double perimeter() const = 0;
 
+    // Площадь, периметр, центр, центр масс и габариты за один проход
+    virtual Figure_Metrics metrics() const = 0;
+
+    // Доступ к вершинам по кругу, index < vertex_count()
+    virtual size_t vertex_count() const = 0;
+    virtual Point<T> vertex(size_t index) const = 0;
+    virtual void set_vertex(size_t index, const Point<T>& point) = 0;
+
     virtual std::shared_ptr<Figure<T>> clone() const = 0;
 
     virtual operator double() const = 0;
 
 private:
-    std::string description = "Figure";
+    Figure_Kind kind;
+    std::uint32_t revision;
+
+    // Версии берутся из общего счётчика, поэтому не повторяются и у фигуры,
+    // созданной по адресу удалённой
+    static std::uint32_t next_revision() {
+        static std::atomic<std::uint32_t> counter{0};
+        return counter.fetch_add(1, std::memory_order_relaxed) + 1;
+    }
 };
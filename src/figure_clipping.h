@@ -0,0 +1,358 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "point.h"
+#include "figure.h"
+#include "bounding_box.h"
+#include "figures_array.h"
+#include "overlap.h"
+
+// Площади пересечений и объединения фигур. Как и в overlap.h, фигуры считаются
+// выпуклыми; порядок обхода вершин любой — он приводится к обходу против часовой стрелки.
+
+struct Figure_Intersection {
+    size_t first;
+    size_t second;
+    double area;
+};
+
+inline double cross_product(double ax, double ay, double bx, double by) {
+    return ax * by - ay * bx;
+}
+
+inline int sign_of(double value) {
+    return (value > 0) - (value < 0);
+}
+
+// Удвоенная ориентированная площадь фигуры i (> 0 — обход против часовой стрелки)
+inline double signed_double_area(const Flat_Polygons& polys, size_t i) {
+    const size_t first = polys.first_vertex(i), n = polys.vertex_count(i);
+    double s = 0;
+    for (size_t k = 0, prev = n - 1; k < n; prev = k++) {
+        s += cross_product(polys.xs[first + prev], polys.ys[first + prev], polys.xs[first + k], polys.ys[first + k]);
+    }
+    return s;
+}
+
+// Развернуть фигуры, заданные по часовой стрелке. Вырожденные (нулевой площади)
+// получают пустые габариты и дальше не участвуют.
+inline void orient_counterclockwise(Flat_Polygons& polys) {
+    for (size_t i = 0; i < polys.size(); ++i) {
+        if (polys.vertex_count(i) == 0) continue;
+        double s = signed_double_area(polys, i);
+        if (s < 0) {
+            std::reverse(polys.xs.begin() + polys.offsets[i], polys.xs.begin() + polys.offsets[i + 1]);
+            std::reverse(polys.ys.begin() + polys.offsets[i], polys.ys.begin() + polys.offsets[i + 1]);
+        } else if (s == 0) {
+            polys.boxes[i] = Bounding_Box{};
+        }
+    }
+}
+
+inline std::vector<Point<double>> polygon_points(const Flat_Polygons& polys, size_t i) {
+    std::vector<Point<double>> points;
+    points.reserve(polys.vertex_count(i));
+    for (size_t v = polys.first_vertex(i); v < polys.offsets[i + 1]; ++v) {
+        points.emplace_back(polys.xs[v], polys.ys[v]);
+    }
+    return points;
+}
+
+inline double signed_double_area(const std::vector<Point<double>>& points) {
+    double s = 0;
+    for (size_t k = 0, prev = points.size() - 1; k < points.size(); prev = k++) {
+        s += cross_product(points[prev].get_x(), points[prev].get_y(), points[k].get_x(), points[k].get_y());
+    }
+    return s;
+}
+
+inline double polygon_area(const std::vector<Point<double>>& points) {
+    return std::abs(signed_double_area(points)) * 0.5;
+}
+
+// Отсечение многоугольника subject выпуклым многоугольником clip (алгоритм Сазерленда — Ходжмена).
+// clip задан против часовой стрелки. Касание по ребру или вершине даёт вырожденный результат нулевой площади.
+inline std::vector<Point<double>> clip_convex(const std::vector<Point<double>>& subject,
+                                              const std::vector<Point<double>>& clip) {
+    std::vector<Point<double>> result = subject, input;
+    for (size_t e = 0; e < clip.size() && !result.empty(); ++e) {
+        const Point<double>& a = clip[e];
+        const Point<double>& b = clip[(e + 1) % clip.size()];
+        const double ex = b.get_x() - a.get_x(), ey = b.get_y() - a.get_y();
+        if (ex == 0.0 && ey == 0.0) continue;  // вырожденное ребро
+        auto side = [&](const Point<double>& p) {
+            return cross_product(ex, ey, p.get_x() - a.get_x(), p.get_y() - a.get_y());
+        };
+
+        input.swap(result);
+        result.clear();
+        for (size_t k = 0; k < input.size(); ++k) {
+            const Point<double>& p = input[k];
+            const Point<double>& q = input[(k + 1) % input.size()];
+            double sp = side(p), sq = side(q);
+            if (sp >= 0) result.push_back(p);
+            if ((sp > 0 && sq < 0) || (sp < 0 && sq > 0)) {
+                double t = sp / (sp - sq);
+                result.emplace_back(p.get_x() + t * (q.get_x() - p.get_x()), p.get_y() + t * (q.get_y() - p.get_y()));
+            }
+        }
+    }
+    return result;
+}
+
+template<Scalar T>
+std::vector<Point<double>> counterclockwise_points(const Figure<T>& figure) {
+    std::vector<Point<double>> points;
+    points.reserve(figure.vertex_count());
+    for (size_t v = 0; v < figure.vertex_count(); ++v) {
+        auto p = figure.vertex(v);
+        points.emplace_back(p.get_x(), p.get_y());
+    }
+    if (signed_double_area(points) < 0) std::reverse(points.begin(), points.end());
+    return points;
+}
+
+// Общая часть двух фигур (пустая, если они не пересекаются)
+template<Scalar T>
+std::vector<Point<double>> intersection_polygon(const Figure<T>& a, const Figure<T>& b) {
+    return clip_convex(counterclockwise_points(a), counterclockwise_points(b));
+}
+
+template<Scalar T>
+double intersection_area(const Figure<T>& a, const Figure<T>& b) {
+    return polygon_area(intersection_polygon(a, b));
+}
+
+// Все пары фигур (i < j) с ненулевой площадью пересечения, по возрастанию индексов.
+// threads == 0 — по числу ядер.
+template<typename FigureType>
+std::vector<Figure_Intersection> pairwise_intersections(const Array_Of_Figures<FigureType>& figures,
+                                                        unsigned threads = 0) {
+    Flat_Polygons polys = flatten_figures(figures);
+    orient_counterclockwise(polys);
+    std::vector<std::pair<size_t, size_t>> candidates = overlap_candidates(polys);
+
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    threads = static_cast<unsigned>(std::min<size_t>(threads, std::max<size_t>(1, candidates.size() / 1024)));
+
+    std::vector<std::vector<Figure_Intersection>> partial(threads);
+    auto clip_pairs = [&](unsigned t) {
+        size_t begin = candidates.size() * t / threads;
+        size_t end = candidates.size() * (t + 1) / threads;
+        for (size_t k = begin; k < end; ++k) {
+            auto [i, j] = candidates[k];
+            if (!convex_polygons_overlap(polys, i, j)) continue;
+            double area = polygon_area(clip_convex(polygon_points(polys, i), polygon_points(polys, j)));
+            if (area > 0) partial[t].push_back({i, j, area});
+        }
+    };
+
+    if (threads == 1) {
+        clip_pairs(0);
+    } else {
+        std::vector<std::thread> workers;
+        for (unsigned t = 0; t < threads; ++t) workers.emplace_back(clip_pairs, t);
+        for (auto& w : workers) w.join();
+    }
+
+    std::vector<Figure_Intersection> result;
+    for (auto& part : partial) result.insert(result.end(), part.begin(), part.end());
+    std::sort(result.begin(), result.end(), [](const Figure_Intersection& l, const Figure_Intersection& r) {
+        return std::pair(l.first, l.second) < std::pair(r.first, r.second);
+    });
+    return result;
+}
+
+// Равномерная сетка тайлов над габаритами всех фигур.
+// Фигура попадает во все тайлы, которые задевают её габариты, а «домашний» тайл —
+// тот, где лежит левый нижний угол габаритов: там её и обрабатывают.
+struct Tile_Grid {
+    Bounding_Box extent;
+    double cell{1};
+    size_t columns{0};
+    size_t rows{0};
+    std::vector<size_t> member_offsets;  // фигуры тайла t: members[member_offsets[t], member_offsets[t + 1])
+    std::vector<size_t> members;
+    std::vector<size_t> home_offsets;    // то же для фигур, чей домашний тайл — t
+    std::vector<size_t> homes;
+
+    explicit Tile_Grid(const Flat_Polygons& polys) {
+        size_t count = 0;
+        double span_sum = 0;
+        for (const Bounding_Box& box : polys.boxes) {
+            if (box.empty()) continue;
+            extent.expand(box.min_x, box.min_y);
+            extent.expand(box.max_x, box.max_y);
+            span_sum += std::max(box.max_x - box.min_x, box.max_y - box.min_y);
+            ++count;
+        }
+        if (count == 0) {
+            member_offsets.assign(1, 0);
+            home_offsets.assign(1, 0);
+            return;
+        }
+
+        // Тайл — пара характерных размеров фигуры, но тайлов не больше O(count)
+        const double width = extent.max_x - extent.min_x, height = extent.max_y - extent.min_y;
+        cell = std::max({2.0 * span_sum / static_cast<double>(count),
+                         std::sqrt(width * height / static_cast<double>(count)),
+                         std::max(width, height) / static_cast<double>(2 * count)});
+        columns = static_cast<size_t>(width / cell) + 1;
+        rows = static_cast<size_t>(height / cell) + 1;
+
+        std::vector<size_t> member_count(tiles() + 1, 0), home_count(tiles() + 1, 0);
+        for_each_placement(polys, [&](size_t, size_t tile) { ++member_count[tile + 1]; },
+                                  [&](size_t, size_t tile) { ++home_count[tile + 1]; });
+        for (size_t t = 0; t < tiles(); ++t) {
+            member_count[t + 1] += member_count[t];
+            home_count[t + 1] += home_count[t];
+        }
+        member_offsets = member_count;
+        home_offsets = home_count;
+        members.resize(member_offsets.back());
+        homes.resize(home_offsets.back());
+        for_each_placement(polys, [&](size_t i, size_t tile) { members[member_count[tile]++] = i; },
+                                  [&](size_t i, size_t tile) { homes[home_count[tile]++] = i; });
+    }
+
+    size_t tiles() const { return columns * rows; }
+
+    size_t column(double x) const {
+        return std::min(columns - 1, static_cast<size_t>((x - extent.min_x) / cell));
+    }
+    size_t row(double y) const {
+        return std::min(rows - 1, static_cast<size_t>((y - extent.min_y) / cell));
+    }
+
+    // Фигуры, чьи габариты пересекают box (без повторов, по возрастанию)
+    void neighbours(const Flat_Polygons& polys, const Bounding_Box& box, std::vector<size_t>& out) const {
+        out.clear();
+        for (size_t r = row(box.min_y); r <= row(box.max_y); ++r) {
+            for (size_t c = column(box.min_x); c <= column(box.max_x); ++c) {
+                size_t tile = r * columns + c;
+                for (size_t k = member_offsets[tile]; k < member_offsets[tile + 1]; ++k) {
+                    if (polys.boxes[members[k]].intersects(box)) out.push_back(members[k]);
+                }
+            }
+        }
+        std::sort(out.begin(), out.end());
+        out.erase(std::unique(out.begin(), out.end()), out.end());
+    }
+
+private:
+    template<typename Member, typename Home>
+    void for_each_placement(const Flat_Polygons& polys, Member&& member, Home&& home) const {
+        for (size_t i = 0; i < polys.size(); ++i) {
+            const Bounding_Box& box = polys.boxes[i];
+            if (box.empty()) continue;
+            home(i, row(box.min_y) * columns + column(box.min_x));
+            for (size_t r = row(box.min_y); r <= row(box.max_y); ++r) {
+                for (size_t c = column(box.min_x); c <= column(box.max_x); ++c) {
+                    member(i, r * columns + c);
+                }
+            }
+        }
+    }
+};
+
+// Вклад непокрытых другими фигурами частей границы фигуры i в удвоенную площадь
+// объединения (формула Грина: сумма векторных произведений по границе объединения).
+// Совпадающие рёбра одного направления засчитываются только фигуре с меньшим номером.
+// (ox, oy) — общее для всех фигур начало координат, уменьшающее погрешность.
+inline double uncovered_boundary(const Flat_Polygons& polys, size_t i, const std::vector<size_t>& neighbours,
+                                 double ox, double oy, std::vector<std::pair<double, int>>& events) {
+    const size_t a0 = polys.first_vertex(i), an = polys.vertex_count(i);
+    double total = 0;
+    for (size_t e = 0; e < an; ++e) {
+        const double ax = polys.xs[a0 + e] - ox, ay = polys.ys[a0 + e] - oy;
+        const double bx = polys.xs[a0 + (e + 1) % an] - ox, by = polys.ys[a0 + (e + 1) % an] - oy;
+        const double dx = bx - ax, dy = by - ay;
+        if (dx == 0.0 && dy == 0.0) continue;
+
+        // События на параметре t ребра A + t (B - A): +1 — вход в чужую фигуру, -1 — выход
+        events.assign({{0.0, 0}, {1.0, 0}});
+        for (size_t j : neighbours) {
+            if (j == i) continue;
+            const size_t c0 = polys.first_vertex(j), cn = polys.vertex_count(j);
+            for (size_t k = 0; k < cn; ++k) {
+                const double cx = polys.xs[c0 + k] - ox, cy = polys.ys[c0 + k] - oy;
+                const double qx = polys.xs[c0 + (k + 1) % cn] - ox, qy = polys.ys[c0 + (k + 1) % cn] - oy;
+                int sc = sign_of(cross_product(dx, dy, cx - ax, cy - ay));
+                int sq = sign_of(cross_product(dx, dy, qx - ax, qy - ay));
+                if (sc != sq) {
+                    double sa = cross_product(qx - cx, qy - cy, ax - cx, ay - cy);
+                    double sb = cross_product(qx - cx, qy - cy, bx - cx, by - cy);
+                    if (std::min(sc, sq) < 0) events.emplace_back(sa / (sa - sb), sign_of(sc - sq));
+                } else if (sc == 0 && sq == 0 && j < i && dx * (qx - cx) + dy * (qy - cy) > 0) {
+                    auto ratio = [&](double px, double py) {
+                        return std::abs(dx) >= std::abs(dy) ? (px - ax) / dx : (py - ay) / dy;
+                    };
+                    events.emplace_back(ratio(cx, cy), 1);
+                    events.emplace_back(ratio(qx, qy), -1);
+                }
+            }
+        }
+
+        std::sort(events.begin(), events.end());
+        for (auto& event : events) event.first = std::clamp(event.first, 0.0, 1.0);
+        double uncovered = 0;
+        int depth = events[0].second;
+        for (size_t k = 1; k < events.size(); ++k) {
+            if (depth == 0) uncovered += events[k].first - events[k - 1].first;
+            depth += events[k].second;
+        }
+        total += cross_product(ax, ay, bx, by) * uncovered;
+    }
+    return total;
+}
+
+// Площадь объединения фигур: перекрытия учитываются один раз.
+// Работа делится по тайлам сетки, каждый поток берёт следующий свободный тайл;
+// фигура сравнивается только с соседями по габаритам. threads == 0 — по числу ядер.
+template<typename FigureType>
+double union_area(const Array_Of_Figures<FigureType>& figures, unsigned threads = 0) {
+    Flat_Polygons polys = flatten_figures(figures);
+    orient_counterclockwise(polys);
+    Tile_Grid grid(polys);
+    if (grid.tiles() == 0) return 0.0;
+
+    const double ox = (grid.extent.min_x + grid.extent.max_x) * 0.5;
+    const double oy = (grid.extent.min_y + grid.extent.max_y) * 0.5;
+
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    threads = static_cast<unsigned>(std::min<size_t>(threads, std::max<size_t>(1, polys.size() / 1024)));
+
+    // Сумма по каждому тайлу отдельно — результат не зависит от числа потоков
+    std::vector<double> tile_area(grid.tiles(), 0.0);
+    std::atomic<size_t> next_tile{0};
+    auto process_tiles = [&]() {
+        std::vector<size_t> neighbours;
+        std::vector<std::pair<double, int>> events;
+        for (size_t tile = next_tile++; tile < grid.tiles(); tile = next_tile++) {
+            double area = 0;
+            for (size_t k = grid.home_offsets[tile]; k < grid.home_offsets[tile + 1]; ++k) {
+                size_t i = grid.homes[k];
+                grid.neighbours(polys, polys.boxes[i], neighbours);
+                area += uncovered_boundary(polys, i, neighbours, ox, oy, events);
+            }
+            tile_area[tile] = area;
+        }
+    };
+
+    if (threads == 1) {
+        process_tiles();
+    } else {
+        std::vector<std::thread> workers;
+        for (unsigned t = 0; t < threads; ++t) workers.emplace_back(process_tiles);
+        for (auto& w : workers) w.join();
+    }
+
+    double total = 0;
+    for (double area : tile_area) total += area;
+    return total * 0.5;
+}
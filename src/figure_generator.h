@@ -0,0 +1,46 @@
+#pragma once
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <numbers>
+#include <random>
+#include "point.h"
+#include "figure.h"
+#include "figure_io.h"
+
+// Генератор случайных корректных фигур: правильные многоугольники со случайными
+// центром, радиусом и поворотом. Одинаковое зерно даёт одинаковую последовательность.
+template<Scalar T>
+class Figure_Generator {
+public:
+    // mix — относительные веса треугольников, шестиугольников и восьмиугольников
+    explicit Figure_Generator(std::uint64_t seed,
+                              std::array<double, figure_kind_count> mix = {1.0, 1.0, 1.0},
+                              double extent = 1000.0, double max_radius = 10.0)
+        : rng(seed), kinds(mix.begin(), mix.end()),
+          coordinate(-extent, extent), radius(max_radius * 0.1, max_radius),
+          angle(0.0, 2.0 * std::numbers::pi) {}
+
+    std::shared_ptr<Figure<T>> next() {
+        auto figure = make_figure<T>(static_cast<Figure_Kind>(kinds(rng)));
+        double cx = coordinate(rng), cy = coordinate(rng);
+        double r = radius(rng), phi = angle(rng);
+        const size_t n = figure->vertex_count();
+        for (size_t i = 0; i < n; ++i) {
+            double a = phi + 2.0 * std::numbers::pi * static_cast<double>(i) / static_cast<double>(n);
+            figure->set_vertex(i, Point<T>(cx + r * std::cos(a), cy + r * std::sin(a)));
+        }
+        return figure;
+    }
+
+    std::mt19937_64& engine() { return rng; }
+
+private:
+    std::mt19937_64 rng;
+    std::discrete_distribution<int> kinds;
+    std::uniform_real_distribution<double> coordinate;
+    std::uniform_real_distribution<double> radius;
+    std::uniform_real_distribution<double> angle;
+};
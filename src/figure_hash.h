@@ -0,0 +1,71 @@
+#pragma once
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include "point.h"
+#include "figure.h"
+
+// Номер узла сетки с шагом tolerance. Хранится в double: целый тип переполнился бы
+// уже при |v| / tolerance > 9.2e18, и далёкие разные точки попали бы в один узел.
+// Сверх 2^53 шаг сетки фактически равен шагу самого double. +0.0 убирает -0.
+inline double quantize(double value, double tolerance) {
+    return std::round(value / tolerance) + 0.0;
+}
+
+// Вершины, округлённые до сетки с шагом tolerance и записанные начиная
+// с лексикографически наименьшей — не зависит от выбора начальной вершины.
+template<Scalar T>
+std::vector<std::pair<double, double>> canonical_vertices(const Figure<T>& figure, double tolerance = 1e-9) {
+    if (!(tolerance > 0) || !std::isfinite(tolerance)) {
+        throw std::invalid_argument("Tolerance must be a positive finite number");
+    }
+    const size_t n = figure.vertex_count();
+    std::vector<std::pair<double, double>> q(n);
+    for (size_t i = 0; i < n; ++i) {
+        Point<T> p = figure.vertex(i);
+        q[i] = {quantize(p.get_x(), tolerance), quantize(p.get_y(), tolerance)};
+    }
+
+    size_t best = 0;
+    for (size_t start = 1; start < n; ++start) {
+        for (size_t k = 0; k < n; ++k) {
+            const auto& a = q[(start + k) % n];
+            const auto& b = q[(best + k) % n];
+            if (a != b) {
+                if (a < b) best = start;
+                break;
+            }
+        }
+    }
+
+    std::vector<std::pair<double, double>> result(n);
+    for (size_t k = 0; k < n; ++k) {
+        result[k] = q[(best + k) % n];
+    }
+    return result;
+}
+
+inline size_t hash_combine(size_t seed, size_t value) {
+    return seed ^ (value + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2));
+}
+
+// Геометрический хеш фигуры: одинаков для фигур с совпадающими (до tolerance) вершинами
+template<Scalar T>
+size_t geometry_hash(const Figure<T>& figure, double tolerance = 1e-9) {
+    size_t seed = figure.vertex_count();
+    for (const auto& [x, y] : canonical_vertices(figure, tolerance)) {
+        seed = hash_combine(seed, std::hash<double>{}(x));
+        seed = hash_combine(seed, std::hash<double>{}(y));
+    }
+    return seed;
+}
+
+template<Scalar T>
+bool same_geometry(const Figure<T>& a, const Figure<T>& b, double tolerance = 1e-9) {
+    return a.vertex_count() == b.vertex_count() &&
+           canonical_vertices(a, tolerance) == canonical_vertices(b, tolerance);
+}
@@ -0,0 +1,47 @@
+#pragma once
+#include <istream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include "point.h"
+#include "figure.h"
+#include "triangle.h"
+#include "hexagon.h"
+#include "octagon.h"
+
+// Создание фигуры заданного типа с нулевыми вершинами
+template<Scalar T>
+std::shared_ptr<Figure<T>> make_figure(Figure_Kind kind) {
+    switch (kind) {
+        case Figure_Kind::triangle: return std::make_shared<Triangle<T>>();
+        case Figure_Kind::hexagon: return std::make_shared<Hexagon<T>>();
+        case Figure_Kind::octagon: return std::make_shared<Octagon<T>>();
+    }
+    return nullptr;
+}
+
+// Создание фигуры по имени типа: "triangle", "hexagon", "octagon"
+template<Scalar T>
+std::shared_ptr<Figure<T>> make_figure(std::string_view name) {
+    auto kind = kind_from_name(name);
+    return kind ? make_figure<T>(*kind) : nullptr;
+}
+
+// Чтение одной фигуры в формате "<тип> (x, y) (x, y) ...".
+// Возвращает nullptr в конце потока.
+template<Scalar T>
+std::shared_ptr<Figure<T>> read_figure(std::istream& is) {
+    std::string name;
+    if (!(is >> name)) {
+        return nullptr;
+    }
+    auto figure = make_figure<T>(name);
+    if (!figure) {
+        throw std::invalid_argument("Unknown figure type: " + name);
+    }
+    if (!(is >> *figure)) {
+        throw std::invalid_argument("Malformed " + name + " coordinates");
+    }
+    return figure;
+}
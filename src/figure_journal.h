@@ -0,0 +1,337 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "point.h"
+#include "figure.h"
+#include "figure_io.h"
+#include "figures_array.h"
+
+struct Journal_Options {
+    size_t group_size{64};              // сколько записей копить до fsync
+    size_t snapshot_min_entries{1024};  // снимок не чаще, чем раз в столько записей
+};
+
+// Журнал изменений Array_Of_Figures с периодическими снимками.
+// Каталог содержит snapshot.bin (полное состояние) и journal.log (изменения после него).
+// Оба файла начинаются с номера поколения: журнал чужого поколения при восстановлении
+// игнорируется, поэтому сбой между записью снимка и очисткой журнала ничего не дублирует.
+// Каждая запись: длина (u32), контрольная сумма (u32), тело. Недописанный хвост отбрасывается.
+template<Scalar T>
+class Figure_Journal {
+public:
+    using FigurePtr = std::shared_ptr<Figure<T>>;
+    using ConstFigurePtr = std::shared_ptr<const Figure<T>>;
+
+    explicit Figure_Journal(const std::string& directory, Journal_Options options = {})
+        : dir(directory), options(options) {
+        std::filesystem::create_directories(dir);
+        recover();
+    }
+
+    Figure_Journal(const Figure_Journal&) = delete;
+    Figure_Journal& operator=(const Figure_Journal&) = delete;
+
+    ~Figure_Journal() {
+        try {
+            commit();
+        } catch (...) {
+        }
+        if (fd >= 0) {
+            ::close(fd);
+        }
+    }
+
+    // Журнал хранит собственную копию: изменения исходной фигуры после вызова
+    // не попадают ни в журнал, ни в состояние
+    void add_figure(const FigurePtr& figure) {
+        if (!figure) {
+            throw std::invalid_argument("Cannot journal an empty figure");
+        }
+        std::vector<char> payload;
+        encode_add(payload, *figure);
+        append_record(payload);
+        figures.add_figure(figure->clone());
+        after_change();
+    }
+
+    void remove_figure(size_t index) {
+        figures.remove_figure(index);
+        std::vector<char> payload{static_cast<char>(op_remove)};
+        put(payload, static_cast<std::uint64_t>(index));
+        append_record(payload);
+        after_change();
+    }
+
+    // Групповая фиксация: накопленные записи одним write и одним fsync.
+    // После сбоя недописанный хвост сначала обрезается до последней фиксации,
+    // иначе повторная запись легла бы за ним и восстановление её не увидело бы.
+    void commit() {
+        if (pending.empty()) {
+            return;
+        }
+        if (torn && ::ftruncate(fd, static_cast<off_t>(committed_size)) != 0) {
+            throw std::runtime_error("Cannot truncate " + log_path().string());
+        }
+        torn = true;
+        write_all(fd, pending.data(), pending.size());
+        if (::fsync(fd) != 0) {
+            throw std::runtime_error("fsync failed for " + log_path().string());
+        }
+        torn = false;
+        committed_size += pending.size();
+        pending.clear();
+        pending_records = 0;
+    }
+
+    // Полный снимок текущего состояния; журнал начинается заново
+    void snapshot() {
+        commit();
+        ++generation;
+
+        std::vector<char> data;
+        put(data, snapshot_magic);
+        put(data, generation);
+        put(data, static_cast<std::uint64_t>(figures.get_size()));
+        for (size_t i = 0; i < figures.get_size(); ++i) {
+            std::vector<char> payload;
+            encode_add(payload, *figures[i]);
+            frame(data, payload);
+        }
+        write_file_atomically(snapshot_path(), data);
+
+        std::vector<char> header;
+        put(header, log_magic);
+        put(header, generation);
+        write_file_atomically(log_path(), header);
+        reopen_log();
+        log_records = 0;
+    }
+
+    // Только для чтения: изменение в обход журнала не было бы записано
+    const Array_Of_Figures<ConstFigurePtr>& get_figures() const { return figures; }
+    size_t get_log_records() const { return log_records; }
+    std::uint64_t get_generation() const { return generation; }
+
+private:
+    static constexpr std::uint64_t snapshot_magic = 0x314E5053474946ULL;  // "FIGSPN1"
+    static constexpr std::uint64_t log_magic = 0x31474F4C474946ULL;       // "FIGLOG1"
+    static constexpr std::uint8_t op_add = 1;
+    static constexpr std::uint8_t op_remove = 2;
+
+    std::filesystem::path dir;
+    Journal_Options options;
+    Array_Of_Figures<ConstFigurePtr> figures;
+    std::uint64_t generation{0};
+    int fd{-1};
+    std::vector<char> pending;
+    size_t pending_records{0};
+    size_t log_records{0};
+    size_t committed_size{0};  // размер журнала после последней успешной фиксации
+    bool torn{false};          // последняя фиксация могла оставить недописанный хвост
+
+    std::filesystem::path snapshot_path() const { return dir / "snapshot.bin"; }
+    std::filesystem::path log_path() const { return dir / "journal.log"; }
+
+    // --- Кодирование ---
+    template<typename V>
+    static void put(std::vector<char>& out, V value) {
+        const char* bytes = reinterpret_cast<const char*>(&value);
+        out.insert(out.end(), bytes, bytes + sizeof(V));
+    }
+
+    template<typename V>
+    static bool get(const std::vector<char>& in, size_t& pos, size_t end, V& value) {
+        if (end - pos < sizeof(V)) {
+            return false;
+        }
+        std::memcpy(&value, in.data() + pos, sizeof(V));
+        pos += sizeof(V);
+        return true;
+    }
+
+    static std::uint32_t checksum(const char* data, size_t size) {
+        std::uint32_t h = 2166136261u;  // FNV-1a
+        for (size_t i = 0; i < size; ++i) {
+            h = (h ^ static_cast<unsigned char>(data[i])) * 16777619u;
+        }
+        return h;
+    }
+
+    static void frame(std::vector<char>& out, const std::vector<char>& payload) {
+        put(out, static_cast<std::uint32_t>(payload.size()));
+        put(out, checksum(payload.data(), payload.size()));
+        out.insert(out.end(), payload.begin(), payload.end());
+    }
+
+    static void encode_add(std::vector<char>& out, const Figure<T>& figure) {
+        put(out, op_add);
+        put(out, static_cast<std::uint8_t>(figure.get_kind()));
+        put(out, static_cast<std::uint8_t>(figure.vertex_count()));
+        for (size_t v = 0; v < figure.vertex_count(); ++v) {
+            Point<T> p = figure.vertex(v);
+            put(out, static_cast<double>(p.get_x()));
+            put(out, static_cast<double>(p.get_y()));
+        }
+    }
+
+    // Применить одну запись к массиву; false — запись повреждена
+    bool apply(const std::vector<char>& in, size_t pos, size_t end) {
+        std::uint8_t op = 0;
+        if (!get(in, pos, end, op)) return false;
+        if (op == op_add) {
+            std::uint8_t kind = 0, n = 0;
+            if (!get(in, pos, end, kind) || !get(in, pos, end, n)) return false;
+            if (kind >= figure_kind_count) return false;
+            FigurePtr figure = make_figure<T>(static_cast<Figure_Kind>(kind));
+            if (n != figure->vertex_count()) return false;
+            for (size_t v = 0; v < n; ++v) {
+                double x = 0, y = 0;
+                if (!get(in, pos, end, x) || !get(in, pos, end, y)) return false;
+                figure->set_vertex(v, Point<T>(x, y));
+            }
+            figures.add_figure(std::move(figure));
+            return true;
+        }
+        if (op == op_remove) {
+            std::uint64_t index = 0;
+            if (!get(in, pos, end, index) || index >= figures.get_size()) return false;
+            figures.remove_figure(static_cast<size_t>(index));
+            return true;
+        }
+        return false;
+    }
+
+    // Проход по записям начиная с pos; возвращает смещение после последней целой записи
+    size_t replay(const std::vector<char>& in, size_t pos, size_t& applied) {
+        applied = 0;
+        while (pos < in.size()) {
+            size_t at = pos;
+            std::uint32_t size = 0, sum = 0;
+            if (!get(in, at, in.size(), size) || !get(in, at, in.size(), sum)) break;
+            if (in.size() - at < size || checksum(in.data() + at, size) != sum) break;
+            if (!apply(in, at, at + size)) break;
+            pos = at + size;
+            ++applied;
+        }
+        return pos;
+    }
+
+    // --- Файлы ---
+    static std::vector<char> read_file(const std::filesystem::path& path) {
+        std::ifstream in(path, std::ios::binary);
+        return std::vector<char>(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+
+    static void write_all(int file, const char* data, size_t size) {
+        while (size > 0) {
+            ssize_t n = ::write(file, data, size);
+            if (n < 0) {
+                throw std::runtime_error("Journal write failed");
+            }
+            data += n;
+            size -= static_cast<size_t>(n);
+        }
+    }
+
+    void sync_directory() const {
+        int dfd = ::open(dir.c_str(), O_RDONLY | O_DIRECTORY);
+        if (dfd >= 0) {
+            ::fsync(dfd);
+            ::close(dfd);
+        }
+    }
+
+    void write_file_atomically(const std::filesystem::path& path, const std::vector<char>& data) const {
+        std::filesystem::path tmp = path;
+        tmp += ".tmp";
+        int file = ::open(tmp.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (file < 0) {
+            throw std::runtime_error("Cannot create " + tmp.string());
+        }
+        write_all(file, data.data(), data.size());
+        ::fsync(file);
+        ::close(file);
+        std::filesystem::rename(tmp, path);
+        sync_directory();
+    }
+
+    void reopen_log() {
+        if (fd >= 0) {
+            ::close(fd);
+        }
+        fd = ::open(log_path().c_str(), O_WRONLY | O_APPEND);
+        if (fd < 0) {
+            throw std::runtime_error("Cannot open " + log_path().string());
+        }
+        committed_size = static_cast<size_t>(std::filesystem::file_size(log_path()));
+        torn = false;
+    }
+
+    // --- Восстановление: снимок, затем хвост журнала ---
+    void recover() {
+        if (std::filesystem::exists(snapshot_path())) {
+            std::vector<char> data = read_file(snapshot_path());
+            size_t pos = 0;
+            std::uint64_t magic = 0, count = 0;
+            if (!get(data, pos, data.size(), magic) || magic != snapshot_magic ||
+                !get(data, pos, data.size(), generation) ||
+                !get(data, pos, data.size(), count)) {
+                throw std::runtime_error("Corrupted snapshot " + snapshot_path().string());
+            }
+            figures.reserve(count);
+            size_t applied = 0;
+            replay(data, pos, applied);
+            if (applied != count) {
+                throw std::runtime_error("Corrupted snapshot " + snapshot_path().string());
+            }
+        }
+
+        std::vector<char> log = read_file(log_path());
+        size_t pos = 0;
+        std::uint64_t magic = 0, log_generation = 0;
+        bool valid = get(log, pos, log.size(), magic) && magic == log_magic &&
+                     get(log, pos, log.size(), log_generation) && log_generation == generation;
+        if (!valid) {
+            std::vector<char> header;
+            put(header, log_magic);
+            put(header, generation);
+            write_file_atomically(log_path(), header);
+        } else {
+            size_t good = replay(log, pos, log_records);
+            if (good != log.size()) {
+                std::filesystem::resize_file(log_path(), good);
+            }
+        }
+        reopen_log();
+    }
+
+    void append_record(const std::vector<char>& payload) {
+        frame(pending, payload);
+        ++pending_records;
+        ++log_records;
+    }
+
+    void after_change() {
+        if (pending_records >= options.group_size) {
+            commit();
+        }
+        // Снимок, когда журнал перерос массив: запись и восстановление остаются
+        // пропорциональны числу изменений
+        if (log_records >= std::max(options.snapshot_min_entries, figures.get_size())) {
+            snapshot();
+        }
+    }
+};
@@ -0,0 +1,143 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <istream>
+#include <memory>
+#include <stdexcept>
+#include <streambuf>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "point.h"
+#include "figure.h"
+#include "figure_io.h"
+#include "figures_array.h"
+
+// Файл, отображённый в память только для чтения
+class Mapped_File {
+public:
+    explicit Mapped_File(const std::string& path) {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw std::runtime_error("Cannot open " + path);
+        }
+        struct stat st{};
+        if (::fstat(fd, &st) != 0) {
+            ::close(fd);
+            throw std::runtime_error("Cannot stat " + path);
+        }
+        length = static_cast<size_t>(st.st_size);
+        if (length > 0) {
+            void* addr = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (addr == MAP_FAILED) {
+                ::close(fd);
+                throw std::runtime_error("Cannot map " + path);
+            }
+            ::madvise(addr, length, MADV_SEQUENTIAL);
+            bytes = static_cast<const char*>(addr);
+        }
+        ::close(fd);
+    }
+
+    Mapped_File(const Mapped_File&) = delete;
+    Mapped_File& operator=(const Mapped_File&) = delete;
+
+    ~Mapped_File() {
+        if (bytes) {
+            ::munmap(const_cast<char*>(bytes), length);
+        }
+    }
+
+    const char* data() const { return bytes; }
+    size_t get_size() const { return length; }
+
+private:
+    const char* bytes{nullptr};
+    size_t length{0};
+};
+
+// Поток ввода поверх участка памяти, без копирования
+class Memory_Streambuf : public std::streambuf {
+public:
+    Memory_Streambuf(const char* begin, const char* end) {
+        char* b = const_cast<char*>(begin);
+        setg(b, b, const_cast<char*>(end));
+    }
+};
+
+// Разбиение текста на parts кусков по границам строк (одна фигура на строку).
+// Возвращает parts + 1 смещений.
+inline std::vector<size_t> split_records(const char* data, size_t size, unsigned parts) {
+    std::vector<size_t> bounds{0};
+    for (unsigned k = 1; k < parts; ++k) {
+        size_t pos = std::max(bounds.back(), size * k / parts);
+        while (pos < size && pos > 0 && data[pos - 1] != '\n') {
+            ++pos;
+        }
+        bounds.push_back(pos);
+    }
+    bounds.push_back(size);
+    return bounds;
+}
+
+// Параллельная загрузка текстового файла фигур через mmap.
+// Каждый поток разбирает свой кусок в отдельный массив, затем массивы склеиваются в порядке файла.
+template<Scalar T>
+Array_Of_Figures<std::shared_ptr<Figure<T>>> load_figures(const std::string& path, unsigned threads = 0) {
+    using FigurePtr = std::shared_ptr<Figure<T>>;
+
+    Mapped_File file(path);
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    // Куски меньше 64 КиБ не стоят отдельного потока
+    threads = static_cast<unsigned>(std::clamp<size_t>(file.get_size() / (64 * 1024), 1, threads));
+
+    std::vector<size_t> bounds = split_records(file.data(), file.get_size(), threads);
+    std::vector<Array_Of_Figures<FigurePtr>> parts(threads);
+    std::vector<std::exception_ptr> errors(threads);
+
+    auto parse_chunk = [&](unsigned t) {
+        try {
+            Memory_Streambuf buf(file.data() + bounds[t], file.data() + bounds[t + 1]);
+            std::istream in(&buf);
+            while (FigurePtr figure = read_figure<T>(in)) {
+                parts[t].add_figure(std::move(figure));
+            }
+        } catch (...) {
+            errors[t] = std::current_exception();
+        }
+    };
+
+    if (threads == 1) {
+        parse_chunk(0);
+    } else {
+        std::vector<std::thread> workers;
+        for (unsigned t = 0; t < threads; ++t) workers.emplace_back(parse_chunk, t);
+        for (auto& w : workers) w.join();
+    }
+
+    size_t total = 0;
+    for (unsigned t = 0; t < threads; ++t) {
+        if (errors[t]) {
+            std::rethrow_exception(errors[t]);
+        }
+        total += parts[t].get_size();
+    }
+
+    Array_Of_Figures<FigurePtr> result;
+    result.reserve(total);
+    for (auto& part : parts) {
+        for (size_t i = 0; i < part.get_size(); ++i) {
+            result.add_figure(std::move(part[i]));
+        }
+    }
+    return result;
+}
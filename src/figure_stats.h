@@ -0,0 +1,223 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <map>
+#include <thread>
+#include <vector>
+#include "point.h"
+#include "figure.h"
+#include "bounding_box.h"
+#include "figures_array.h"
+
+// Скетч квантилей с относительной погрешностью: значения раскладываются
+// по логарифмическим корзинам (gamma^(i-1), gamma^i]. Память зависит только
+// от диапазона значений, скетчи можно объединять.
+class Quantile_Sketch {
+public:
+    explicit Quantile_Sketch(double relative_accuracy = 0.01)
+        : gamma((1 + relative_accuracy) / (1 - relative_accuracy)),
+          log_gamma(std::log(gamma)) {}
+
+    void add(double value) {
+        ++count;
+        if (value <= min_positive) {
+            ++zero_count;
+            return;
+        }
+        ++buckets[static_cast<int>(std::ceil(std::log(value) / log_gamma))];
+    }
+
+    void merge(const Quantile_Sketch& other) {
+        count += other.count;
+        zero_count += other.zero_count;
+        for (const auto& [index, n] : other.buckets) {
+            buckets[index] += n;
+        }
+    }
+
+    // q в [0, 1]; для пустого скетча — 0
+    double quantile(double q) const {
+        if (count == 0) {
+            return 0.0;
+        }
+        size_t rank = static_cast<size_t>(std::clamp(q, 0.0, 1.0) * static_cast<double>(count - 1));
+        if (rank < zero_count) {
+            return 0.0;
+        }
+        size_t seen = zero_count;
+        for (const auto& [index, n] : buckets) {
+            seen += n;
+            if (rank < seen) {
+                return 2.0 * std::pow(gamma, index) / (gamma + 1.0);
+            }
+        }
+        return 2.0 * std::pow(gamma, buckets.rbegin()->first) / (gamma + 1.0);
+    }
+
+    size_t get_count() const { return count; }
+    size_t bucket_count() const { return buckets.size(); }
+
+private:
+    static constexpr double min_positive = 1e-300;
+
+    double gamma;
+    double log_gamma;
+    std::map<int, size_t> buckets;
+    size_t zero_count{0};
+    size_t count{0};
+};
+
+// min/max/среднее и квантили одной величины
+struct Value_Summary {
+    size_t count{0};
+    double min{std::numeric_limits<double>::infinity()};
+    double max{-std::numeric_limits<double>::infinity()};
+    double sum{0};
+    Quantile_Sketch sketch;
+
+    explicit Value_Summary(double relative_accuracy = 0.01) : sketch(relative_accuracy) {}
+
+    void add(double value) {
+        ++count;
+        min = std::min(min, value);
+        max = std::max(max, value);
+        sum += value;
+        sketch.add(value);
+    }
+
+    void merge(const Value_Summary& other) {
+        count += other.count;
+        min = std::min(min, other.min);
+        max = std::max(max, other.max);
+        sum += other.sum;
+        sketch.merge(other.sketch);
+    }
+
+    double mean() const { return count ? sum / static_cast<double>(count) : 0.0; }
+    double quantile(double q) const { return sketch.quantile(q); }
+};
+
+struct Statistics_Options {
+    double area_bin_width{1.0};   // ширина корзины гистограммы площадей
+    size_t area_bins{16};         // последняя корзина собирает всё, что больше
+    double relative_accuracy{0.01};
+    unsigned threads{0};          // 0 — по числу ядер
+};
+
+// Статистика по группе фигур
+struct Kind_Statistics {
+    size_t count{0};
+    Value_Summary area;
+    Value_Summary perimeter;
+    std::vector<size_t> area_histogram;
+
+    // Распределение центров
+    double center_sum_x{0}, center_sum_y{0};
+    double center_sum_xx{0}, center_sum_yy{0};
+    Bounding_Box center_bounds;
+
+    explicit Kind_Statistics(const Statistics_Options& options = {})
+        : area(options.relative_accuracy), perimeter(options.relative_accuracy),
+          area_histogram(std::max<size_t>(1, options.area_bins), 0) {}
+
+    void add(double a, double p, double cx, double cy, double bin_width) {
+        ++count;
+        area.add(a);
+        perimeter.add(p);
+        size_t bin = (bin_width > 0 && a >= 0) ? static_cast<size_t>(a / bin_width) : 0;
+        ++area_histogram[std::min(bin, area_histogram.size() - 1)];
+        center_sum_x += cx;
+        center_sum_y += cy;
+        center_sum_xx += cx * cx;
+        center_sum_yy += cy * cy;
+        center_bounds.expand(cx, cy);
+    }
+
+    void merge(const Kind_Statistics& other) {
+        count += other.count;
+        area.merge(other.area);
+        perimeter.merge(other.perimeter);
+        for (size_t b = 0; b < area_histogram.size() && b < other.area_histogram.size(); ++b) {
+            area_histogram[b] += other.area_histogram[b];
+        }
+        center_sum_x += other.center_sum_x;
+        center_sum_y += other.center_sum_y;
+        center_sum_xx += other.center_sum_xx;
+        center_sum_yy += other.center_sum_yy;
+        if (!other.center_bounds.empty()) {
+            center_bounds.expand(other.center_bounds.min_x, other.center_bounds.min_y);
+            center_bounds.expand(other.center_bounds.max_x, other.center_bounds.max_y);
+        }
+    }
+
+    Point<double> center_mean() const {
+        if (count == 0) return Point<double>();
+        return Point<double>(center_sum_x / count, center_sum_y / count);
+    }
+
+    // Среднеквадратичное отклонение центров по осям
+    Point<double> center_stddev() const {
+        if (count == 0) return Point<double>();
+        Point<double> m = center_mean();
+        double vx = center_sum_xx / count - m.get_x() * m.get_x();
+        double vy = center_sum_yy / count - m.get_y() * m.get_y();
+        return Point<double>(std::sqrt(std::max(0.0, vx)), std::sqrt(std::max(0.0, vy)));
+    }
+};
+
+struct Figure_Statistics {
+    std::array<Kind_Statistics, figure_kind_count> by_kind;
+    Kind_Statistics overall;
+
+    explicit Figure_Statistics(const Statistics_Options& options = {})
+        : overall(options) {
+        by_kind.fill(Kind_Statistics(options));
+    }
+
+    const Kind_Statistics& of(Figure_Kind kind) const { return by_kind[static_cast<size_t>(kind)]; }
+};
+
+// Вся статистика за один проход по массиву; массив делится на куски по потокам,
+// частичные результаты объединяются.
+template<typename FigureType>
+Figure_Statistics compute_statistics(const Array_Of_Figures<FigureType>& figures,
+                                     const Statistics_Options& options = {}) {
+    const size_t n = figures.get_size();
+    unsigned threads = options.threads ? options.threads : std::max(1u, std::thread::hardware_concurrency());
+    threads = static_cast<unsigned>(std::clamp<size_t>(n / 4096, 1, threads));
+
+    std::vector<Figure_Statistics> partial(threads, Figure_Statistics(options));
+    auto accumulate = [&](unsigned t) {
+        size_t begin = n * t / threads, end = n * (t + 1) / threads;
+        for (size_t i = begin; i < end; ++i) {
+            const auto& figure = figures[i];
+            if (!figure) continue;
+            Figure_Metrics m = figure->metrics();
+            partial[t].by_kind[static_cast<size_t>(figure->get_kind())].add(
+                m.area, m.perimeter,
+                m.center.get_x(), m.center.get_y(), options.area_bin_width);
+        }
+    };
+
+    if (threads == 1) {
+        accumulate(0);
+    } else {
+        std::vector<std::thread> workers;
+        for (unsigned t = 0; t < threads; ++t) workers.emplace_back(accumulate, t);
+        for (auto& w : workers) w.join();
+    }
+
+    Figure_Statistics result = std::move(partial[0]);
+    for (unsigned t = 1; t < threads; ++t) {
+        for (size_t k = 0; k < figure_kind_count; ++k) {
+            result.by_kind[k].merge(partial[t].by_kind[k]);
+        }
+    }
+    for (size_t k = 0; k < figure_kind_count; ++k) {
+        result.overall.merge(result.by_kind[k]);
+    }
+    return result;
+}
@@ -0,0 +1,97 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <istream>
+#include <memory>
+#include <ostream>
+#include <thread>
+#include <vector>
+#include "point.h"
+#include "figure.h"
+#include "figure_io.h"
+#include "spsc_queue.h"
+
+// Потоковая обработка: чтение -> вычисление -> вывод.
+// Стадии связаны ограниченными SPSC-очередями, поэтому память не растёт с длиной входа.
+// Задания раздаются обработчикам по кругу и так же по кругу собираются — порядок вывода
+// совпадает с порядком ввода. Возвращает число обработанных фигур.
+template<Scalar T>
+size_t stream_figures(std::istream& in, std::ostream& out,
+                      unsigned workers = 0, size_t queue_capacity = 256) {
+    struct Job {
+        std::shared_ptr<Figure<T>> figure;
+        bool last{false};
+    };
+    struct Result {
+        Figure_Kind kind{};
+        Figure_Metrics metrics;
+        bool last{false};
+    };
+
+    if (workers == 0) {
+        workers = std::max(1u, std::thread::hardware_concurrency());
+    }
+    size_t per_worker = std::max<size_t>(1, queue_capacity / workers);
+
+    std::vector<std::unique_ptr<Spsc_Queue<Job>>> jobs;
+    std::vector<std::unique_ptr<Spsc_Queue<Result>>> results;
+    for (unsigned w = 0; w < workers; ++w) {
+        jobs.push_back(std::make_unique<Spsc_Queue<Job>>(per_worker));
+        results.push_back(std::make_unique<Spsc_Queue<Result>>(per_worker));
+    }
+
+    std::exception_ptr parse_error;
+    std::thread parser([&] {
+        size_t index = 0;
+        try {
+            Job job;
+            while ((job.figure = read_figure<T>(in))) {
+                jobs[index++ % workers]->push(std::move(job));
+                job = Job{};
+            }
+        } catch (...) {
+            parse_error = std::current_exception();
+        }
+        for (unsigned w = 0; w < workers; ++w) {
+            Job end;
+            end.last = true;
+            jobs[(index + w) % workers]->push(std::move(end));
+        }
+    });
+
+    std::vector<std::thread> computers;
+    for (unsigned w = 0; w < workers; ++w) {
+        computers.emplace_back([&, w] {
+            for (;;) {
+                Job job = jobs[w]->pop();
+                Result result;
+                result.last = job.last;
+                if (!job.last) {
+                    result.kind = job.figure->get_kind();
+                    result.metrics = job.figure->metrics();
+                }
+                results[w]->push(std::move(result));
+                if (job.last) break;
+            }
+        });
+    }
+
+    size_t count = 0;
+    for (;; ++count) {
+        Result result = results[count % workers]->pop();
+        if (result.last) break;
+        out << kind_name(result.kind) << " center: " << result.metrics.center
+            << " area: " << result.metrics.area
+            << " perimeter: " << result.metrics.perimeter << '\n';
+    }
+    out.flush();
+
+    parser.join();
+    for (auto& c : computers) c.join();
+
+    if (parse_error) {
+        std::rethrow_exception(parse_error);
+    }
+    return count;
+}
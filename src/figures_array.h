@@ -1,17 +1,31 @@
 #pragma once
 
 #include "figure.h"
+#include "bounding_box.h"
+#include "figure_hash.h"
 #include <cstddef>
+#include <cstdint>
 #include <iostream>
 #include <initializer_list>
+#include <mutex>
 #include <algorithm>
+#include <array>
+#include <atomic>
 #include <stdexcept>
 #include <type_traits>
+#include <unordered_map>
+#include <vector>
+#include <span>
+#include <ranges>
 #include <utility>
 
 template<typename FigureType>
 class Array_Of_Figures {
 public:
+    using value_type = FigureType;
+    using iterator = typename std::span<FigureType>::iterator;
+    using const_iterator = typename std::span<const FigureType>::iterator;
+
     Array_Of_Figures() = default;
 
     Array_Of_Figures(size_t cap) {
@@ -64,6 +78,8 @@ public:
         other.figures = nullptr;
         other.size = 0;
         other.capacity = 0;
+        invalidate_caches();
+        other.invalidate_caches();
         return *this;
     }
 
@@ -73,13 +89,30 @@ public:
         if (size >= capacity) {
             resize();
         }
-        figures[size++] = figure;
+        figures[size++] = std::move(figure);
+        // Новые ячейки лежат за концом кэшей и пересчитываются без отметки
+        bounds_stale.store(true, std::memory_order_relaxed);
+    }
+
+    // Заранее выделить место под new_capacity элементов
+    void reserve(size_t new_capacity) {
+        if (new_capacity <= capacity) {
+            return;
+        }
+        std::shared_ptr<FigureType[]> new_figures = std::make_shared<FigureType[]>(new_capacity);
+        std::fill_n(new_figures.get(), new_capacity, FigureType{});
+        for (size_t i = 0; i < size; ++i) {
+            new_figures[i] = std::move(figures[i]);
+        }
+        figures = new_figures;
+        capacity = new_capacity;
     }
 
     FigureType& operator[](size_t index) {
         if (index >= size) {
             throw std::out_of_range("Index out of range");
         }
+        mark_changed(index);
         return figures[index];
     }
 
@@ -90,6 +123,47 @@ public:
         return figures[index];
     }
 
+    // Доступ без проверки индекса, index < get_size()
+    const FigureType& unchecked(size_t index) const {
+        return figures[index];
+    }
+
+    FigureType& unchecked(size_t index) {
+        mark_changed(index);
+        return figures[index];
+    }
+
+    // Непрерывные итераторы: range-for, std::ranges и параллельные алгоритмы
+    std::span<const FigureType> items() const {
+        return std::span<const FigureType>(figures.get(), size);
+    }
+
+    // Через итераторы элементы могут переставить или заменить. Кэши при следующем
+    // запросе сверят адрес и версию каждой фигуры и пересчитают лишь изменившиеся.
+    std::span<FigureType> items() {
+        mark_all_changed();
+        return std::span<FigureType>(figures.get(), size);
+    }
+
+    const_iterator begin() const { return items().begin(); }
+    const_iterator end() const { return items().end(); }
+    iterator begin() { return items().begin(); }
+    iterator end() { return items().end(); }
+
+    // Фигуры заданного типа, без копирования
+    auto of_kind(Figure_Kind kind) const {
+        return items() | std::views::filter([kind](const FigureType& figure) {
+            return figure && figure->get_kind() == kind;
+        });
+    }
+
+    // Площади фигур (0 для пустых ячеек)
+    auto areas() const {
+        return items() | std::views::transform([](const FigureType& figure) {
+            return figure ? figure->square() : 0.0;
+        });
+    }
+
     void remove_figure(size_t index) {
         if (index >= size) {
             throw std::out_of_range("Index out of range");
@@ -99,6 +173,17 @@ public:
         }
         --size;
         figures[size] = FigureType{};
+        if (index < bounds_keys.size()) {
+            bounds_keys.erase(bounds_keys.begin() + index);
+            bounds_cache.erase(index);
+        }
+        if (index < hash_keys.size()) {
+            hash_keys.erase(hash_keys.begin() + index);
+            hash_values.erase(hash_values.begin() + index);
+        }
+        hash_buckets_stale = true;
+        bounds_changes.erase(index);
+        hash_changes.erase(index);
     }
 
     size_t get_size() const { return size; }
@@ -112,6 +197,29 @@ public:
         }
     }
 
+    // Метрики всех фигур; для пустых ячеек — нулевые
+    std::vector<Figure_Metrics> metrics() const {
+        std::vector<Figure_Metrics> result(size);
+        for (size_t i = 0; i < size; ++i) {
+            if (figures[i]) {
+                result[i] = figures[i]->metrics();
+            }
+        }
+        return result;
+    }
+
+    // Центр, площадь и периметр каждой фигуры — вершины читаются один раз
+    void print_report(std::ostream& os) const {
+        for (size_t i = 0; i < size; ++i) {
+            if (figures[i]) {
+                Figure_Metrics m = figures[i]->metrics();
+                os << figures[i]->get_name() << " center: " << m.center
+                   << " area: " << m.area
+                   << " perimeter: " << m.perimeter << '\n';
+            }
+        }
+    }
+
     double total_square() const {
         double total = 0.0;
         for (size_t i = 0; i < size; ++i) {
@@ -122,24 +230,295 @@ public:
         return total;
     }
 
+    // Фигуры заданного типа (указатели разделяются с исходным массивом)
+    Array_Of_Figures filter_by_kind(Figure_Kind kind) const {
+        Array_Of_Figures result;
+        for (size_t i = 0; i < size; ++i) {
+            if (figures[i] && figures[i]->get_kind() == kind) {
+                result.add_figure(figures[i]);
+            }
+        }
+        return result;
+    }
+
+    // Разбиение по типам за один проход, индекс — static_cast<size_t>(Figure_Kind)
+    std::array<Array_Of_Figures, figure_kind_count> group_by_kind() const {
+        std::array<size_t, figure_kind_count> counts{};
+        for (size_t i = 0; i < size; ++i) {
+            if (figures[i]) ++counts[static_cast<size_t>(figures[i]->get_kind())];
+        }
+        std::array<Array_Of_Figures, figure_kind_count> groups;
+        for (size_t k = 0; k < figure_kind_count; ++k) {
+            groups[k].reserve(counts[k]);
+        }
+        for (size_t i = 0; i < size; ++i) {
+            if (figures[i]) groups[static_cast<size_t>(figures[i]->get_kind())].add_figure(figures[i]);
+        }
+        return groups;
+    }
+
+    // Индексы фигур с теми же вершинами, что у figure (с точностью до начальной вершины).
+    // Сравниваются только фигуры из корзины хеш-индекса с тем же геометрическим хешем.
+    // Индекс обновляется лишь по ячейкам, изменённым через массив; изменения в обход
+    // массива учитываются после refresh_caches().
+    template<typename F>
+    std::vector<size_t> find_equal(const F& figure, double tolerance = 1e-9) const {
+        std::lock_guard<std::mutex> lock(hash_mutex);
+        update_hash_index(tolerance);
+        std::vector<size_t> result;
+        auto bucket = hash_buckets.find(geometry_hash(figure, tolerance));
+        if (bucket == hash_buckets.end()) {
+            return result;
+        }
+        for (size_t i : bucket->second) {
+            if (same_geometry(*figures[i], figure, tolerance)) {
+                result.push_back(i);
+            }
+        }
+        return result;
+    }
+
+    // Удалить повторы, оставив первое вхождение. Возвращает число удалённых фигур.
+    size_t deduplicate(double tolerance = 1e-9) {
+        std::unordered_map<size_t, std::vector<size_t>> index;
+        index.reserve(size);
+        size_t kept = 0;
+        for (size_t i = 0; i < size; ++i) {
+            if (figures[i]) {
+                auto& bucket = index[geometry_hash(*figures[i], tolerance)];
+                bool duplicate = std::any_of(bucket.begin(), bucket.end(), [&](size_t j) {
+                    return same_geometry(*figures[j], *figures[i], tolerance);
+                });
+                if (duplicate) continue;
+                bucket.push_back(kept);
+            }
+            figures[kept++] = std::move(figures[i]);
+        }
+        invalidate_caches();
+        size_t removed = size - kept;
+        for (size_t i = kept; i < size; ++i) {
+            figures[i] = FigureType{};
+        }
+        size = kept;
+        return removed;
+    }
+
+    // Кэши габаритов и хеш-индекса следят за изменениями, сделанными через массив:
+    // добавление, удаление, неконстантный доступ к ячейке и итераторы. Если фигуру
+    // изменили в обход массива (set_vertex у общей фигуры, запись через сохранённую
+    // ссылку), об этом сообщают refresh_caches(): при следующем запросе у каждой
+    // ячейки сверяются адрес фигуры и номер её версии.
+    void refresh_caches() {
+        mark_all_changed();
+        update_bounds();
+    }
+
+    Bounding_Box bounds_of(size_t index) const {
+        if (index >= size) {
+            throw std::out_of_range("Index out of range");
+        }
+        update_bounds();
+        return bounds_cache.get(index);
+    }
+
+    // Индексы фигур, чьи габариты пересекают окно; точную проверку делает вызывающий.
+    // Без изменений в массиве запрос только читает кэш и не блокирует другие запросы.
+    std::vector<size_t> cull_by_window(const Bounding_Box& window) const {
+        update_bounds();
+        return bounds_cache.intersecting(window);
+    }
+
 private:
     std::shared_ptr<FigureType[]> figures{nullptr};
     size_t size{0};
     size_t capacity{0};
 
-    void resize() {
-        capacity = (capacity == 0) ? 1 : capacity * 2;
-        std::shared_ptr<FigureType[]> new_figures = std::make_shared<FigureType[]>(capacity);
-        std::fill_n(new_figures.get(), capacity, FigureType{});
+    // По какой фигуре и какой её версии посчитано закэшированное значение ячейки
+    struct Figure_Key {
+        const void* figure{nullptr};
+        std::uint32_t revision{0};
+
+        bool operator==(const Figure_Key&) const = default;
+    };
+
+    // Ячейки, которые могли измениться через массив с последнего обновления кэша.
+    // Ячейки за концом кэша (только что добавленные) отдельно не отмечаются.
+    struct Changed_Slots {
+        std::vector<size_t> slots;
+        bool all{true};
+
+        void mark(size_t index, size_t size) {
+            if (all) return;
+            if (slots.size() >= size) {
+                mark_all();
+                return;
+            }
+            slots.push_back(index);
+        }
+
+        void mark_all() {
+            all = true;
+            slots.clear();
+        }
+
+        // Ячейку index удалили, следующие сдвинулись на одну назад
+        void erase(size_t index) {
+            std::erase(slots, index);
+            for (size_t& slot : slots) {
+                if (slot > index) --slot;
+            }
+        }
+
+        void clear() {
+            all = false;
+            slots.clear();
+        }
+    };
+
+    // Кэш габаритов: структура массивов + ключи. bounds_stale поднимают неконстантные
+    // операции; первый же запрос обновляет кэш под мьютексом, остальные только читают.
+    mutable Bounding_Box_Array bounds_cache;
+    mutable std::vector<Figure_Key> bounds_keys;
+    mutable Changed_Slots bounds_changes;
+    mutable std::atomic<bool> bounds_stale{true};
+    mutable std::mutex bounds_mutex;
+
+    // Хеш-индекс для find_equal: хеш каждой ячейки и корзины хеш -> индексы.
+    // Пересчитываются только отмеченные ячейки; корзины перестраиваются целиком
+    // лишь после удаления или полной сверки.
+    mutable double hash_tolerance{0};
+    mutable std::vector<Figure_Key> hash_keys;
+    mutable std::vector<size_t> hash_values;
+    mutable std::unordered_map<size_t, std::vector<size_t>> hash_buckets;
+    mutable Changed_Slots hash_changes;
+    mutable bool hash_buckets_stale{true};
+    mutable std::mutex hash_mutex;
+
+    void mark_changed(size_t index) {
+        bounds_changes.mark(index, size);
+        hash_changes.mark(index, size);
+        bounds_stale.store(true, std::memory_order_relaxed);
+    }
+
+    void mark_all_changed() {
+        bounds_changes.mark_all();
+        hash_changes.mark_all();
+        bounds_stale.store(true, std::memory_order_relaxed);
+    }
+
+    Figure_Key key_of(size_t index) const {
+        if (!figures[index]) {
+            return Figure_Key{};
+        }
+        return Figure_Key{&*figures[index], figures[index]->get_revision()};
+    }
+
+    void update_bounds() const {
+        if (!bounds_stale.load(std::memory_order_acquire)) {
+            return;
+        }
+        std::lock_guard<std::mutex> lock(bounds_mutex);
+        if (!bounds_stale.load(std::memory_order_relaxed)) {
+            return;
+        }
+        size_t cached = std::min(bounds_keys.size(), size);
+        bounds_cache.resize(size);
+        bounds_keys.resize(size);
+        if (bounds_changes.all) {
+            for (size_t i = 0; i < size; ++i) update_bounds_slot(i);
+        } else {
+            for (size_t i : bounds_changes.slots) update_bounds_slot(i);
+            for (size_t i = cached; i < size; ++i) update_bounds_slot(i);
+        }
+        bounds_changes.clear();
+        bounds_stale.store(false, std::memory_order_release);
+    }
+
+    void update_bounds_slot(size_t i) const {
+        Figure_Key key = key_of(i);
+        if (bounds_keys[i] != key) {
+            bounds_cache.set(i, figures[i] ? figures[i]->metrics().bounds : Bounding_Box{});
+            bounds_keys[i] = key;
+        }
+    }
+
+    void update_hash_index(double tolerance) const {
+        if (tolerance != hash_tolerance) {
+            hash_keys.clear();
+            hash_values.clear();
+            hash_changes.mark_all();
+            hash_tolerance = tolerance;
+        }
+        size_t cached = std::min(hash_keys.size(), size);
+        hash_keys.resize(size);
+        hash_values.resize(size, 0);
+        bool rebuild = hash_buckets_stale || hash_changes.all;
+        if (hash_changes.all) {
+            for (size_t i = 0; i < size; ++i) update_hash_slot(i, false);
+        } else {
+            for (size_t i : hash_changes.slots) update_hash_slot(i, !rebuild);
+            for (size_t i = cached; i < size; ++i) update_hash_slot(i, !rebuild);
+        }
+        hash_changes.clear();
+        if (!rebuild) {
+            return;
+        }
+        hash_buckets.clear();
         for (size_t i = 0; i < size; ++i) {
-            new_figures[i] = figures[i];
+            if (figures[i]) {
+                hash_buckets[hash_values[i]].push_back(i);
+            }
         }
-        figures = new_figures;
+        hash_buckets_stale = false;
+    }
+
+    // Пересчитать хеш ячейки; keep_buckets — сразу перенести её в нужную корзину
+    void update_hash_slot(size_t i, bool keep_buckets) const {
+        Figure_Key key = key_of(i);
+        if (hash_keys[i] == key) {
+            return;
+        }
+        if (keep_buckets && hash_keys[i].figure) {
+            auto old = hash_buckets.find(hash_values[i]);
+            std::erase(old->second, i);
+            if (old->second.empty()) hash_buckets.erase(old);
+        }
+        hash_values[i] = figures[i] ? geometry_hash(*figures[i], hash_tolerance) : 0;
+        hash_keys[i] = key;
+        if (keep_buckets && figures[i]) {
+            auto& bucket = hash_buckets[hash_values[i]];
+            bucket.insert(std::lower_bound(bucket.begin(), bucket.end(), i), i);
+        }
+    }
+
+    void invalidate_caches() {
+        bounds_cache.clear();
+        bounds_keys.clear();
+        hash_keys.clear();
+        hash_values.clear();
+        hash_buckets_stale = true;
+        mark_all_changed();
+    }
+
+    void resize() {
+        reserve((capacity == 0) ? 1 : capacity * 2);
     }
 
     void swap(Array_Of_Figures& other) noexcept {
         std::swap(figures, other.figures);
         std::swap(size, other.size);
         std::swap(capacity, other.capacity);
+        std::swap(bounds_cache, other.bounds_cache);
+        std::swap(bounds_keys, other.bounds_keys);
+        std::swap(hash_tolerance, other.hash_tolerance);
+        std::swap(hash_keys, other.hash_keys);
+        std::swap(hash_values, other.hash_values);
+        std::swap(hash_buckets, other.hash_buckets);
+        std::swap(hash_buckets_stale, other.hash_buckets_stale);
+        std::swap(bounds_changes, other.bounds_changes);
+        std::swap(hash_changes, other.hash_changes);
+        bool stale = bounds_stale.load(std::memory_order_relaxed);
+        bounds_stale.store(other.bounds_stale.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        other.bounds_stale.store(stale, std::memory_order_relaxed);
     }
 };
\ No newline at end of file
@@ -9,16 +9,15 @@
 template<Scalar T>
 class Hexagon : public Figure<T> {
 public:
-    Hexagon() : Figure<T>("hexagon") {
+    Hexagon() : Figure<T>(Figure_Kind::hexagon) {
         for (int i = 0; i < 6; ++i)
             points[i] = std::make_unique<Point<T>>();
     }
 
     // 6 точек, вводятся по кругу
     Hexagon(const Point<T>& p1, const Point<T>& p2, const Point<T>& p3,
-            const Point<T>& p4, const Point<T>& p5, const Point<T>& p6,
-            std::string desc = "hexagon")
-        : Figure<T>(desc)
+            const Point<T>& p4, const Point<T>& p5, const Point<T>& p6)
+        : Figure<T>(Figure_Kind::hexagon)
     {
         points[0] = std::make_unique<Point<T>>(p1);
         points[1] = std::make_unique<Point<T>>(p2);
@@ -28,7 +27,7 @@ public:
         points[5] = std::make_unique<Point<T>>(p6);
     }
 
-    Hexagon(const Hexagon& other) : Figure<T>("hexagon") {
+    Hexagon(const Hexagon& other) : Figure<T>(Figure_Kind::hexagon) {
         for (int i = 0; i < 6; ++i)
             points[i] = std::make_unique<Point<T>>(*other.points[i]);
     }
@@ -37,11 +36,12 @@ public:
         if (this != &other) {
             for (int i = 0; i < 6; ++i)
                 points[i] = std::make_unique<Point<T>>(*other.points[i]);
+            this->touch();
         }
         return *this;
     }
 
-    Hexagon(Hexagon&& other) noexcept {
+    Hexagon(Hexagon&& other) noexcept : Figure<T>(Figure_Kind::hexagon) {
         for (int i = 0; i < 6; ++i)
             points[i] = std::move(other.points[i]);
     }
@@ -50,6 +50,7 @@ public:
         if (this != &other) {
             for (int i = 0; i < 6; ++i)
                 points[i] = std::move(other.points[i]);
+            this->touch();
         }
         return *this;
     }
@@ -63,7 +64,7 @@ public:
     }
 
     // Геометрический центр — среднее всех координат
-    std::unique_ptr<Point<T>> geometric_center() const override {
+    Point<T> center() const override {
         double cx = 0, cy = 0;
         for (int i = 0; i < 6; ++i) {
             cx += points[i]->get_x();
@@ -71,7 +72,7 @@ public:
         }
         cx /= 6.0;
         cy /= 6.0;
-        return std::make_unique<Point<T>>(cx, cy);
+        return Point<T>(cx, cy);
     }
 
     // Площадь — многоугольник через формулу Гаусса
@@ -92,6 +93,23 @@ public:
         return p;
     }
 
+    Figure_Metrics metrics() const override {
+        return this->polygon_metrics(points);
+    }
+
+    size_t vertex_count() const override {
+        return 6;
+    }
+
+    Point<T> vertex(size_t index) const override {
+        return *points[index];
+    }
+
+    void set_vertex(size_t index, const Point<T>& point) override {
+        points[index]->move(point.get_x(), point.get_y());
+        this->touch();
+    }
+
     operator double() const override {
         return square();
     }
@@ -104,6 +122,7 @@ public:
     void read(std::istream& is) override {
         for (int i = 0; i < 6; ++i)
             is >> *points[i];
+        this->touch();
     }
 
     std::shared_ptr<Figure<T>> clone() const override {
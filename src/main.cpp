@@ -1,7 +1,13 @@
+#include <algorithm>
+#include <cctype>
+#include <cmath>
 #include <iostream>
 #include <sstream>
 #include <utility>
 #include <memory>
+#include <array>
+#include <string>
+#include <stdexcept>
 
 #include "point.h"
 #include "figure.h"
@@ -10,8 +16,10 @@
 #include "hexagon.h"
 #include "octagon.h"
 #include "triangle.h"
+#include "figure_stream.h"
+#include "workload.h"
 
-int main() {
+static int run_demo() {
     using std::cout;
     using std::endl;
 
@@ -96,6 +104,9 @@ int main() {
          << arr.get_size() << ", cap=" << arr.get_capacity() << "):" << endl;
     arr.print_figures(cout);
 
+    cout << "Метрики фигур массива:" << endl;
+    arr.print_report(cout);
+
     cout << "Общая площадь: " << arr.total_square() << endl;
 
 
@@ -143,3 +154,97 @@ int main() {
     }
     return 0;
 }
+
+// Потоковый режим: фигуры из stdin по одной на строку, например
+//   triangle (0,0) (4,0) (0,3)
+// для каждой выводятся центр, площадь и периметр в порядке ввода.
+// Необязательный аргумент — число потоков-обработчиков (0..1024, 0 — по числу ядер).
+static int run_stream(int argc, char** argv) {
+    unsigned workers = 0;
+    try {
+        if (argc > 2) {
+            std::string value = argv[2];
+            bool digits = !value.empty() && value.size() <= 4 &&
+                          std::all_of(value.begin(), value.end(), [](unsigned char c) { return std::isdigit(c); });
+            if (!digits || std::stoul(value) > 1024) {
+                throw std::invalid_argument("Invalid worker count: " + value);
+            }
+            workers = static_cast<unsigned>(std::stoul(value));
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Ошибка аргументов: " << e.what() << std::endl;
+        return 1;
+    }
+
+    std::ios::sync_with_stdio(false);
+    try {
+        stream_figures<double>(std::cin, std::cout, workers);
+    } catch (const std::exception& e) {
+        std::cerr << "Ошибка ввода: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+// Список весов через запятую: "1,2,0.5". Веса неотрицательны, хотя бы один больше нуля —
+// иначе std::discrete_distribution не определён.
+template<size_t N>
+static std::array<double, N> parse_weights(const std::string& text) {
+    std::array<double, N> weights{};
+    std::istringstream in(text);
+    std::string item;
+    double sum = 0;
+    for (size_t i = 0; i < N; ++i) {
+        if (!std::getline(in, item, ',')) {
+            throw std::invalid_argument("Expected " + std::to_string(N) + " weights: " + text);
+        }
+        weights[i] = std::stod(item);
+        if (!std::isfinite(weights[i]) || weights[i] < 0) {
+            throw std::invalid_argument("Weight must be a non-negative number: " + item);
+        }
+        sum += weights[i];
+    }
+    if (sum <= 0) {
+        throw std::invalid_argument("At least one weight must be positive: " + text);
+    }
+    return weights;
+}
+
+// Режим нагрузки: --generate N [--ops M] [--seed S] [--mix t,h,o] [--op-mix add,remove,index,area,print]
+static int run_load_generator(int argc, char** argv) {
+    Workload_Options options;
+    try {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (i + 1 >= argc) {
+                throw std::invalid_argument("Missing value for " + arg);
+            }
+            std::string value = argv[++i];
+            if (arg == "--generate") options.figures = std::stoull(value);
+            else if (arg == "--ops") options.operations = std::stoull(value);
+            else if (arg == "--seed") options.seed = std::stoull(value);
+            else if (arg == "--mix") options.type_mix = parse_weights<figure_kind_count>(value);
+            else if (arg == "--op-mix") options.op_mix = parse_weights<workload_op_count>(value);
+            else throw std::invalid_argument("Unknown option " + arg);
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Ошибка аргументов: " << e.what() << std::endl;
+        return 1;
+    }
+
+    Null_Streambuf null_buffer;
+    std::ostream null_sink(&null_buffer);
+    Workload_Report report = run_workload<double>(options, null_sink);
+    print_workload_report(std::cout, report);
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    if (argc > 1 && std::string(argv[1]) == "--stream") {
+        return run_stream(argc, argv);
+    }
+    if (argc > 1 && std::string(argv[1]) == "--generate") {
+        return run_load_generator(argc, argv);
+    }
+    return run_demo();
+}
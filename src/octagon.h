@@ -9,15 +9,14 @@
 template<Scalar T>
 class Octagon : public Figure<T> {
 public:
-    Octagon() : Figure<T>("octagon") {
+    Octagon() : Figure<T>(Figure_Kind::octagon) {
         for (int i = 0; i < 8; ++i)
             points[i] = std::make_unique<Point<T>>();
     }
 
     Octagon(const Point<T>& p1, const Point<T>& p2, const Point<T>& p3, const Point<T>& p4,
-            const Point<T>& p5, const Point<T>& p6, const Point<T>& p7, const Point<T>& p8,
-            std::string desc = "octagon")
-        : Figure<T>(desc)
+            const Point<T>& p5, const Point<T>& p6, const Point<T>& p7, const Point<T>& p8)
+        : Figure<T>(Figure_Kind::octagon)
     {
         points[0] = std::make_unique<Point<T>>(p1);
         points[1] = std::make_unique<Point<T>>(p2);
@@ -29,7 +28,7 @@ public:
         points[7] = std::make_unique<Point<T>>(p8);
     }
 
-    Octagon(const Octagon& other) : Figure<T>("octagon") {
+    Octagon(const Octagon& other) : Figure<T>(Figure_Kind::octagon) {
         for (int i = 0; i < 8; ++i)
             points[i] = std::make_unique<Point<T>>(*other.points[i]);
     }
@@ -38,11 +37,12 @@ public:
         if (this != &other) {
             for (int i = 0; i < 8; ++i)
                 points[i] = std::make_unique<Point<T>>(*other.points[i]);
+            this->touch();
         }
         return *this;
     }
 
-    Octagon(Octagon&& other) noexcept {
+    Octagon(Octagon&& other) noexcept : Figure<T>(Figure_Kind::octagon) {
         for (int i = 0; i < 8; ++i)
             points[i] = std::move(other.points[i]);
     }
@@ -51,6 +51,7 @@ public:
         if (this != &other) {
             for (int i = 0; i < 8; ++i)
                 points[i] = std::move(other.points[i]);
+            this->touch();
         }
         return *this;
     }
@@ -63,13 +64,13 @@ public:
         return this->square() <=> other.square();
     }
 
-    std::unique_ptr<Point<T>> geometric_center() const override {
+    Point<T> center() const override {
         double cx = 0, cy = 0;
         for (int i = 0; i < 8; ++i) {
             cx += points[i]->get_x();
             cy += points[i]->get_y();
         }
-        return std::make_unique<Point<T>>(cx / 8.0, cy / 8.0);
+        return Point<T>(cx / 8.0, cy / 8.0);
     }
 
     double square() const override {
@@ -89,6 +90,23 @@ public:
         return p;
     }
 
+    Figure_Metrics metrics() const override {
+        return this->polygon_metrics(points);
+    }
+
+    size_t vertex_count() const override {
+        return 8;
+    }
+
+    Point<T> vertex(size_t index) const override {
+        return *points[index];
+    }
+
+    void set_vertex(size_t index, const Point<T>& point) override {
+        points[index]->move(point.get_x(), point.get_y());
+        this->touch();
+    }
+
     operator double() const override {
         return square();
     }
@@ -101,6 +119,7 @@ public:
     void read(std::istream& is) override {
         for (int i = 0; i < 8; ++i)
             is >> *points[i];
+        this->touch();
     }
 
     std::shared_ptr<Figure<T>> clone() const override {
@@ -0,0 +1,141 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "point.h"
+#include "figure.h"
+#include "bounding_box.h"
+#include "figures_array.h"
+
+// Вершины всех фигур массива, уложенные подряд (без виртуальных вызовов при проверках)
+struct Flat_Polygons {
+    std::vector<double> xs;
+    std::vector<double> ys;
+    std::vector<size_t> offsets{0};  // вершины фигуры i: [offsets[i], offsets[i + 1])
+    std::vector<Bounding_Box> boxes;
+
+    size_t size() const { return boxes.size(); }
+    size_t first_vertex(size_t i) const { return offsets[i]; }
+    size_t vertex_count(size_t i) const { return offsets[i + 1] - offsets[i]; }
+};
+
+template<typename FigureType>
+Flat_Polygons flatten_figures(const Array_Of_Figures<FigureType>& figures) {
+    Flat_Polygons polys;
+    polys.boxes.reserve(figures.get_size());
+    polys.offsets.reserve(figures.get_size() + 1);
+    for (size_t i = 0; i < figures.get_size(); ++i) {
+        Bounding_Box box;
+        if (const auto& figure = figures[i]) {
+            for (size_t v = 0; v < figure->vertex_count(); ++v) {
+                auto p = figure->vertex(v);
+                polys.xs.push_back(p.get_x());
+                polys.ys.push_back(p.get_y());
+                box.expand(p.get_x(), p.get_y());
+            }
+        }
+        polys.offsets.push_back(polys.xs.size());
+        polys.boxes.push_back(box);
+    }
+    return polys;
+}
+
+// Есть ли среди нормалей к рёбрам a разделяющая ось. Касание считается разделением.
+inline bool has_separating_axis(const Flat_Polygons& polys, size_t a, size_t b, bool& any_axis) {
+    const size_t a0 = polys.first_vertex(a), an = polys.vertex_count(a);
+    const size_t b0 = polys.first_vertex(b), bn = polys.vertex_count(b);
+    for (size_t i = 0; i < an; ++i) {
+        size_t j = (i + 1) % an;
+        double nx = polys.ys[a0 + i] - polys.ys[a0 + j];
+        double ny = polys.xs[a0 + j] - polys.xs[a0 + i];
+        if (nx == 0.0 && ny == 0.0) continue;  // вырожденное ребро
+        any_axis = true;
+
+        double min_a = nx * polys.xs[a0] + ny * polys.ys[a0], max_a = min_a;
+        for (size_t k = 1; k < an; ++k) {
+            double d = nx * polys.xs[a0 + k] + ny * polys.ys[a0 + k];
+            min_a = std::min(min_a, d);
+            max_a = std::max(max_a, d);
+        }
+        double min_b = nx * polys.xs[b0] + ny * polys.ys[b0], max_b = min_b;
+        for (size_t k = 1; k < bn; ++k) {
+            double d = nx * polys.xs[b0 + k] + ny * polys.ys[b0 + k];
+            min_b = std::min(min_b, d);
+            max_b = std::max(max_b, d);
+        }
+        if (max_a <= min_b || max_b <= min_a) return true;
+    }
+    return false;
+}
+
+// Точная проверка пересечения выпуклых многоугольников (теорема о разделяющей оси)
+inline bool convex_polygons_overlap(const Flat_Polygons& polys, size_t a, size_t b) {
+    if (polys.vertex_count(a) == 0 || polys.vertex_count(b) == 0) return false;
+    bool axes_a = false, axes_b = false;
+    if (has_separating_axis(polys, a, b, axes_a)) return false;
+    if (has_separating_axis(polys, b, a, axes_b)) return false;
+    return axes_a && axes_b;
+}
+
+// Широкая фаза: sweep-and-prune по оси x, затем отсечение по y
+inline std::vector<std::pair<size_t, size_t>> overlap_candidates(const Flat_Polygons& polys) {
+    std::vector<size_t> order;
+    order.reserve(polys.size());
+    for (size_t i = 0; i < polys.size(); ++i) {
+        if (!polys.boxes[i].empty()) order.push_back(i);
+    }
+    std::sort(order.begin(), order.end(), [&](size_t l, size_t r) {
+        return polys.boxes[l].min_x < polys.boxes[r].min_x;
+    });
+
+    std::vector<std::pair<size_t, size_t>> candidates;
+    for (size_t i = 0; i < order.size(); ++i) {
+        const Bounding_Box& box = polys.boxes[order[i]];
+        for (size_t j = i + 1; j < order.size(); ++j) {
+            const Bounding_Box& other = polys.boxes[order[j]];
+            if (other.min_x > box.max_x) break;
+            if (other.min_y <= box.max_y && box.min_y <= other.max_y) {
+                candidates.emplace_back(std::min(order[i], order[j]), std::max(order[i], order[j]));
+            }
+        }
+    }
+    return candidates;
+}
+
+// Все пары пересекающихся фигур (i < j), отсортированные по возрастанию.
+// threads == 0 — по числу ядер.
+template<typename FigureType>
+std::vector<std::pair<size_t, size_t>> find_overlaps(const Array_Of_Figures<FigureType>& figures,
+                                                     unsigned threads = 0) {
+    Flat_Polygons polys = flatten_figures(figures);
+    std::vector<std::pair<size_t, size_t>> candidates = overlap_candidates(polys);
+
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    threads = static_cast<unsigned>(std::min<size_t>(threads, std::max<size_t>(1, candidates.size() / 1024)));
+
+    std::vector<std::vector<std::pair<size_t, size_t>>> partial(threads);
+    auto narrow_phase = [&](unsigned t) {
+        size_t begin = candidates.size() * t / threads;
+        size_t end = candidates.size() * (t + 1) / threads;
+        for (size_t k = begin; k < end; ++k) {
+            if (convex_polygons_overlap(polys, candidates[k].first, candidates[k].second)) {
+                partial[t].push_back(candidates[k]);
+            }
+        }
+    };
+
+    if (threads == 1) {
+        narrow_phase(0);
+    } else {
+        std::vector<std::thread> workers;
+        for (unsigned t = 0; t < threads; ++t) workers.emplace_back(narrow_phase, t);
+        for (auto& w : workers) w.join();
+    }
+
+    std::vector<std::pair<size_t, size_t>> result;
+    for (auto& part : partial) result.insert(result.end(), part.begin(), part.end());
+    std::sort(result.begin(), result.end());
+    return result;
+}
@@ -0,0 +1,335 @@
+#pragma once
+#include <atomic>
+#include <cerrno>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "point.h"
+#include "figure.h"
+#include "bounding_box.h"
+#include "figures_array.h"
+
+// Хранилище фигур в разделяемой памяти POSIX.
+// Писатель публикует неизменяемые снимки в сегментах "<name>.<версия>", номер
+// актуальной версии лежит в управляющем сегменте "<name>". Внутри снимка только
+// смещения от начала сегмента, поэтому его можно отобразить по любому адресу.
+// Читатели работают прямо с отображённой памятью, без копирования.
+
+struct Shared_Store_Control {
+    std::uint64_t magic;
+    std::atomic<std::uint64_t> version;
+};
+
+struct Shared_Snapshot_Header {
+    std::uint64_t magic;
+    std::uint64_t version;
+    std::uint64_t count;
+    std::uint64_t vertex_total;
+    std::uint64_t records_offset;
+    std::uint64_t boxes_offset;
+    std::uint64_t xs_offset;
+    std::uint64_t ys_offset;
+    std::uint64_t total_bytes;
+};
+
+struct Shared_Figure_Record {
+    std::uint8_t kind;
+    std::uint8_t vertices;
+    std::uint8_t reserved[6];
+    std::uint64_t first_vertex;
+};
+
+inline constexpr std::uint64_t shared_control_magic = 0x4C5254434749464CULL;
+inline constexpr std::uint64_t shared_snapshot_magic = 0x50414E5347494646ULL;
+
+inline std::string shared_snapshot_name(const std::string& name, std::uint64_t version) {
+    return name + "." + std::to_string(version);
+}
+
+// Отображение сегмента разделяемой памяти (RAII)
+class Shared_Mapping {
+public:
+    Shared_Mapping() = default;
+
+    Shared_Mapping(const std::string& name, size_t size, bool create, bool writable) {
+        int flags = writable ? O_RDWR : O_RDONLY;
+        if (create) flags |= O_CREAT | O_TRUNC;
+        int fd = ::shm_open(name.c_str(), flags, 0644);
+        if (fd < 0) {
+            throw std::runtime_error("shm_open failed for " + name + ": " + std::strerror(errno));
+        }
+        if (create && ::ftruncate(fd, static_cast<off_t>(size)) != 0) {
+            ::close(fd);
+            throw std::runtime_error("ftruncate failed for " + name);
+        }
+        if (!create) {
+            struct stat st{};
+            ::fstat(fd, &st);
+            size = static_cast<size_t>(st.st_size);
+        }
+        int prot = writable ? (PROT_READ | PROT_WRITE) : PROT_READ;
+        void* addr = ::mmap(nullptr, size, prot, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (addr == MAP_FAILED) {
+            throw std::runtime_error("mmap failed for " + name);
+        }
+        base = static_cast<std::byte*>(addr);
+        length = size;
+    }
+
+    Shared_Mapping(Shared_Mapping&& other) noexcept : base(other.base), length(other.length) {
+        other.base = nullptr;
+        other.length = 0;
+    }
+
+    Shared_Mapping& operator=(Shared_Mapping&& other) noexcept {
+        if (this != &other) {
+            unmap();
+            base = other.base;
+            length = other.length;
+            other.base = nullptr;
+            other.length = 0;
+        }
+        return *this;
+    }
+
+    Shared_Mapping(const Shared_Mapping&) = delete;
+    Shared_Mapping& operator=(const Shared_Mapping&) = delete;
+
+    ~Shared_Mapping() { unmap(); }
+
+    template<typename V>
+    V& at(size_t offset) const { return *reinterpret_cast<V*>(base + offset); }
+
+    template<typename V>
+    std::span<V> array(size_t offset, size_t count) const {
+        return std::span<V>(reinterpret_cast<V*>(base + offset), count);
+    }
+
+    size_t get_size() const { return length; }
+
+private:
+    std::byte* base{nullptr};
+    size_t length{0};
+
+    void unmap() {
+        if (base) {
+            ::munmap(base, length);
+            base = nullptr;
+        }
+    }
+};
+
+// Писатель: единственный процесс, публикующий снимки
+class Shared_Figure_Publisher {
+public:
+    explicit Shared_Figure_Publisher(std::string name)
+        : name(std::move(name)),
+          control(this->name, sizeof(Shared_Store_Control), true, true) {
+        auto& c = control.at<Shared_Store_Control>(0);
+        c.magic = shared_control_magic;
+        c.version.store(0, std::memory_order_release);
+    }
+
+    Shared_Figure_Publisher(const Shared_Figure_Publisher&) = delete;
+    Shared_Figure_Publisher& operator=(const Shared_Figure_Publisher&) = delete;
+
+    ~Shared_Figure_Publisher() {
+        if (version > 0) {
+            ::shm_unlink(shared_snapshot_name(name, version).c_str());
+        }
+        ::shm_unlink(name.c_str());
+    }
+
+    // Записать новый снимок и сделать его актуальным. Возвращает номер версии.
+    template<typename FigureType>
+    std::uint64_t publish(const Array_Of_Figures<FigureType>& figures) {
+        size_t count = 0, vertex_total = 0;
+        for (size_t i = 0; i < figures.get_size(); ++i) {
+            if (figures[i]) {
+                ++count;
+                vertex_total += figures[i]->vertex_count();
+            }
+        }
+
+        Shared_Snapshot_Header header{};
+        header.magic = shared_snapshot_magic;
+        header.version = version + 1;
+        header.count = count;
+        header.vertex_total = vertex_total;
+        header.records_offset = sizeof(Shared_Snapshot_Header);
+        header.boxes_offset = header.records_offset + count * sizeof(Shared_Figure_Record);
+        header.xs_offset = header.boxes_offset + count * sizeof(Bounding_Box);
+        header.ys_offset = header.xs_offset + vertex_total * sizeof(double);
+        header.total_bytes = header.ys_offset + vertex_total * sizeof(double);
+
+        std::string segment = shared_snapshot_name(name, header.version);
+        {
+            Shared_Mapping snapshot(segment, header.total_bytes, true, true);
+            auto records = snapshot.array<Shared_Figure_Record>(header.records_offset, count);
+            auto boxes = snapshot.array<Bounding_Box>(header.boxes_offset, count);
+            auto xs = snapshot.array<double>(header.xs_offset, vertex_total);
+            auto ys = snapshot.array<double>(header.ys_offset, vertex_total);
+
+            size_t r = 0, v = 0;
+            for (size_t i = 0; i < figures.get_size(); ++i) {
+                const auto& figure = figures[i];
+                if (!figure) continue;
+                Shared_Figure_Record record{};
+                record.kind = static_cast<std::uint8_t>(figure->get_kind());
+                record.vertices = static_cast<std::uint8_t>(figure->vertex_count());
+                record.first_vertex = v;
+                Bounding_Box box;
+                for (size_t k = 0; k < figure->vertex_count(); ++k, ++v) {
+                    auto p = figure->vertex(k);
+                    xs[v] = p.get_x();
+                    ys[v] = p.get_y();
+                    box.expand(xs[v], ys[v]);
+                }
+                records[r] = record;
+                boxes[r] = box;
+                ++r;
+            }
+            snapshot.at<Shared_Snapshot_Header>(0) = header;
+        }
+
+        control.at<Shared_Store_Control>(0).version.store(header.version, std::memory_order_release);
+        // Старый снимок убираем из пространства имён; уже отобразившие его читатели
+        // продолжают работать, память освободится после их munmap
+        if (version > 0) {
+            ::shm_unlink(shared_snapshot_name(name, version).c_str());
+        }
+        version = header.version;
+        return version;
+    }
+
+    std::uint64_t get_version() const { return version; }
+
+private:
+    std::string name;
+    Shared_Mapping control;
+    std::uint64_t version{0};
+};
+
+// Читатель: неизменяемый снимок, отображённый только для чтения
+class Shared_Figure_View {
+public:
+    // Отобразить последнюю опубликованную версию
+    static Shared_Figure_View open_latest(const std::string& name) {
+        Shared_Mapping control(name, 0, false, false);
+        const auto& c = control.at<const Shared_Store_Control>(0);
+        if (control.get_size() < sizeof(Shared_Store_Control) || c.magic != shared_control_magic) {
+            throw std::runtime_error("Not a figure store: " + name);
+        }
+        // Писатель мог успеть опубликовать новую версию и удалить прочитанную — повторяем
+        for (int attempt = 0; attempt < 100; ++attempt) {
+            std::uint64_t v = c.version.load(std::memory_order_acquire);
+            if (v == 0) {
+                throw std::runtime_error("Nothing published yet in " + name);
+            }
+            try {
+                return Shared_Figure_View(name, Shared_Mapping(shared_snapshot_name(name, v), 0, false, false));
+            } catch (const std::runtime_error&) {
+                if (c.version.load(std::memory_order_acquire) == v) throw;
+            }
+        }
+        throw std::runtime_error("Figure store " + name + " changes too fast");
+    }
+
+    // Есть ли более новая версия, чем отображённая
+    bool is_stale() const {
+        Shared_Mapping control(name, 0, false, false);
+        return control.at<const Shared_Store_Control>(0).version.load(std::memory_order_acquire) != header().version;
+    }
+
+    std::uint64_t get_version() const { return header().version; }
+    size_t get_size() const { return static_cast<size_t>(header().count); }
+
+    Figure_Kind kind(size_t i) const { return static_cast<Figure_Kind>(records()[i].kind); }
+    size_t vertex_count(size_t i) const { return records()[i].vertices; }
+
+    Point<double> vertex(size_t i, size_t k) const {
+        size_t v = records()[i].first_vertex + k;
+        return Point<double>(xs()[v], ys()[v]);
+    }
+
+    const Bounding_Box& bounds(size_t i) const { return boxes()[i]; }
+
+    double square(size_t i) const {
+        const auto& r = records()[i];
+        auto x = xs().subspan(r.first_vertex, r.vertices);
+        auto y = ys().subspan(r.first_vertex, r.vertices);
+        double s = 0;
+        for (size_t k = 0, prev = r.vertices - 1; k < r.vertices; prev = k++) {
+            s += x[prev] * y[k] - x[k] * y[prev];
+        }
+        return std::abs(s) * 0.5;
+    }
+
+    double perimeter(size_t i) const {
+        const auto& r = records()[i];
+        auto x = xs().subspan(r.first_vertex, r.vertices);
+        auto y = ys().subspan(r.first_vertex, r.vertices);
+        double p = 0;
+        for (size_t k = 0, prev = r.vertices - 1; k < r.vertices; prev = k++) {
+            p += std::hypot(x[k] - x[prev], y[k] - y[prev]);
+        }
+        return p;
+    }
+
+    double total_square() const {
+        double total = 0;
+        for (size_t i = 0; i < get_size(); ++i) total += square(i);
+        return total;
+    }
+
+    // Индексы фигур, чьи габариты пересекают окно
+    std::vector<size_t> query(const Bounding_Box& window) const {
+        std::vector<size_t> result;
+        auto all = boxes();
+        for (size_t i = 0; i < all.size(); ++i) {
+            if (all[i].intersects(window)) result.push_back(i);
+        }
+        return result;
+    }
+
+private:
+    std::string name;
+    Shared_Mapping mapping;
+
+    Shared_Figure_View(std::string name, Shared_Mapping mapping)
+        : name(std::move(name)), mapping(std::move(mapping)) {
+        if (this->mapping.get_size() < sizeof(Shared_Snapshot_Header) ||
+            header().magic != shared_snapshot_magic ||
+            header().total_bytes > this->mapping.get_size()) {
+            throw std::invalid_argument("Corrupted figure snapshot in " + this->name);
+        }
+    }
+
+    const Shared_Snapshot_Header& header() const { return mapping.at<const Shared_Snapshot_Header>(0); }
+
+    std::span<const Shared_Figure_Record> records() const {
+        return mapping.array<const Shared_Figure_Record>(header().records_offset, header().count);
+    }
+    std::span<const Bounding_Box> boxes() const {
+        return mapping.array<const Bounding_Box>(header().boxes_offset, header().count);
+    }
+    std::span<const double> xs() const {
+        return mapping.array<const double>(header().xs_offset, header().vertex_total);
+    }
+    std::span<const double> ys() const {
+        return mapping.array<const double>(header().ys_offset, header().vertex_total);
+    }
+};
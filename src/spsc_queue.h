@@ -0,0 +1,90 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Ограниченная lock-free очередь: один производитель, один потребитель
+template<typename T>
+class Spsc_Queue {
+public:
+    explicit Spsc_Queue(size_t capacity) : buffer(capacity + 1) {}
+
+    Spsc_Queue(const Spsc_Queue&) = delete;
+    Spsc_Queue& operator=(const Spsc_Queue&) = delete;
+
+    bool try_push(T&& value) {
+        size_t t = tail.load(std::memory_order_relaxed);
+        size_t next = (t + 1) % buffer.size();
+        if (next == head.load(std::memory_order_acquire)) {
+            return false;
+        }
+        buffer[t] = std::move(value);
+        tail.store(next);
+        if (consumer_waiting.load()) {
+            tail.notify_one();
+        }
+        return true;
+    }
+
+    bool try_pop(T& value) {
+        size_t h = head.load(std::memory_order_relaxed);
+        if (h == tail.load(std::memory_order_acquire)) {
+            return false;
+        }
+        value = std::move(buffer[h]);
+        head.store((h + 1) % buffer.size());
+        if (producer_waiting.load()) {
+            head.notify_one();
+        }
+        return true;
+    }
+
+    // Блокирующие варианты: сначала недолго уступают процессор, затем засыпают
+    // на atomic::wait, пока другая сторона не сдвинет индекс
+    void push(T value) {
+        for (unsigned spin = 0; !try_push(std::move(value)); ++spin) {
+            if (spin < spin_limit) {
+                std::this_thread::yield();
+                continue;
+            }
+            producer_waiting.store(true);
+            size_t h = head.load();
+            if ((tail.load(std::memory_order_relaxed) + 1) % buffer.size() == h) {
+                head.wait(h);
+            }
+            producer_waiting.store(false, std::memory_order_relaxed);
+        }
+    }
+
+    T pop() {
+        T value;
+        for (unsigned spin = 0; !try_pop(value); ++spin) {
+            if (spin < spin_limit) {
+                std::this_thread::yield();
+                continue;
+            }
+            consumer_waiting.store(true);
+            size_t t = tail.load();
+            if (head.load(std::memory_order_relaxed) == t) {
+                tail.wait(t);
+            }
+            consumer_waiting.store(false, std::memory_order_relaxed);
+        }
+        return value;
+    }
+
+    size_t get_capacity() const { return buffer.size() - 1; }
+
+private:
+    static constexpr unsigned spin_limit = 64;
+
+    std::vector<T> buffer;
+    alignas(64) std::atomic<size_t> head{0};
+    alignas(64) std::atomic<size_t> tail{0};
+    // Флаги спящих сторон: индекс публикуется и флаг читается с seq_cst,
+    // поэтому либо спящий увидит новый индекс, либо его разбудят
+    alignas(64) std::atomic<bool> producer_waiting{false};
+    std::atomic<bool> consumer_waiting{false};
+};
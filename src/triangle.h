@@ -9,14 +9,13 @@
 template<Scalar T>
 class Triangle : public Figure<T> {
 public:
-    Triangle() : Figure<T>("triangle") {
+    Triangle() : Figure<T>(Figure_Kind::triangle) {
         for (int i = 0; i < 3; ++i)
             points[i] = std::make_unique<Point<T>>();
     }
 
-    Triangle(const Point<T>& p1, const Point<T>& p2, const Point<T>& p3,
-             std::string desc = "triangle")
-        : Figure<T>(desc)
+    Triangle(const Point<T>& p1, const Point<T>& p2, const Point<T>& p3)
+        : Figure<T>(Figure_Kind::triangle)
     {
         points[0] = std::make_unique<Point<T>>(p1);
         points[1] = std::make_unique<Point<T>>(p2);
@@ -24,7 +23,7 @@ public:
     }
 
     // --- Копирование ---
-    Triangle(const Triangle& other) : Figure<T>("triangle") {
+    Triangle(const Triangle& other) : Figure<T>(Figure_Kind::triangle) {
         for (int i = 0; i < 3; ++i)
             points[i] = std::make_unique<Point<T>>(*other.points[i]);
     }
@@ -33,12 +32,13 @@ public:
         if (this != &other) {
             for (int i = 0; i < 3; ++i)
                 points[i] = std::make_unique<Point<T>>(*other.points[i]);
+            this->touch();
         }
         return *this;
     }
 
     // --- Перемещение ---
-    Triangle(Triangle&& other) noexcept {
+    Triangle(Triangle&& other) noexcept : Figure<T>(Figure_Kind::triangle) {
         for (int i = 0; i < 3; ++i)
             points[i] = std::move(other.points[i]);
     }
@@ -47,6 +47,7 @@ public:
         if (this != &other) {
             for (int i = 0; i < 3; ++i)
                 points[i] = std::move(other.points[i]);
+            this->touch();
         }
         return *this;
     }
@@ -61,13 +62,13 @@ public:
     }
 
     // --- Геометрический центр ---
-    std::unique_ptr<Point<T>> geometric_center() const override {
+    Point<T> center() const override {
         double cx = 0, cy = 0;
         for (int i = 0; i < 3; ++i) {
             cx += points[i]->get_x();
             cy += points[i]->get_y();
         }
-        return std::make_unique<Point<T>>(cx / 3.0, cy / 3.0);
+        return Point<T>(cx / 3.0, cy / 3.0);
     }
 
     // --- Площадь ---
@@ -90,6 +91,25 @@ public:
                distance(*points[2], *points[0]);
     }
 
+    // --- Все метрики за один проход ---
+    Figure_Metrics metrics() const override {
+        return this->polygon_metrics(points);
+    }
+
+    // --- Вершины ---
+    size_t vertex_count() const override {
+        return 3;
+    }
+
+    Point<T> vertex(size_t index) const override {
+        return *points[index];
+    }
+
+    void set_vertex(size_t index, const Point<T>& point) override {
+        points[index]->move(point.get_x(), point.get_y());
+        this->touch();
+    }
+
     operator double() const override {
         return square();
     }
@@ -104,6 +124,7 @@ public:
     void read(std::istream& is) override {
         for (int i = 0; i < 3; ++i)
             is >> *points[i];
+        this->touch();
     }
 
     // --- Клонирование ---
@@ -0,0 +1,145 @@
+#pragma once
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iomanip>
+#include <memory>
+#include <ostream>
+#include <random>
+#include <streambuf>
+#include <string_view>
+
+#include <sys/resource.h>
+
+#include "point.h"
+#include "figure.h"
+#include "figures_array.h"
+#include "figure_generator.h"
+#include "figure_stats.h"
+
+enum class Workload_Op : std::uint8_t {
+    add,
+    remove,
+    index,
+    total_area,
+    print,
+};
+
+inline constexpr size_t workload_op_count = 5;
+
+inline constexpr std::string_view workload_op_names[workload_op_count] = {
+    "add", "remove", "index", "total_area", "print",
+};
+
+struct Workload_Options {
+    size_t figures{100000};     // сколько фигур создать до начала операций
+    size_t operations{100000};
+    std::uint64_t seed{1};
+    std::array<double, figure_kind_count> type_mix{1.0, 1.0, 1.0};
+    std::array<double, workload_op_count> op_mix{4.0, 2.0, 10.0, 0.01, 1.0};
+};
+
+struct Op_Report {
+    size_t count{0};
+    Quantile_Sketch latency_ns;
+};
+
+struct Workload_Report {
+    size_t figures{0};           // размер массива в конце
+    double fill_seconds{0};      // время создания начальных фигур
+    double seconds{0};           // время выполнения операций
+    size_t operations{0};
+    std::array<Op_Report, workload_op_count> ops;
+    long peak_rss_kb{0};
+
+    double throughput() const { return seconds > 0 ? operations / seconds : 0.0; }
+};
+
+// Поток, который форматирует вывод и выбрасывает его — print меряется без терминала
+class Null_Streambuf : public std::streambuf {
+protected:
+    int_type overflow(int_type ch) override { return traits_type::not_eof(ch); }
+    std::streamsize xsputn(const char*, std::streamsize n) override { return n; }
+};
+
+inline long peak_rss_kb() {
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;  // в Linux — килобайты
+}
+
+// Синтетическая нагрузка на Array_Of_Figures: заполнение случайными фигурами,
+// затем случайная смесь операций с замером задержки каждой
+template<Scalar T>
+Workload_Report run_workload(const Workload_Options& options, std::ostream& print_sink) {
+    using Clock = std::chrono::steady_clock;
+
+    Figure_Generator<T> generator(options.seed, options.type_mix);
+    std::discrete_distribution<int> pick_op(options.op_mix.begin(), options.op_mix.end());
+    Array_Of_Figures<std::shared_ptr<Figure<T>>> figures;
+    Workload_Report report;
+
+    auto fill_start = Clock::now();
+    figures.reserve(options.figures);
+    for (size_t i = 0; i < options.figures; ++i) {
+        figures.add_figure(generator.next());
+    }
+    report.fill_seconds = std::chrono::duration<double>(Clock::now() - fill_start).count();
+
+    double sink = 0;
+    auto start = Clock::now();
+    for (size_t n = 0; n < options.operations; ++n) {
+        auto op = static_cast<Workload_Op>(pick_op(generator.engine()));
+        if (figures.get_size() == 0 && op != Workload_Op::add) {
+            op = Workload_Op::add;
+        }
+        size_t index = figures.get_size() ? generator.engine()() % figures.get_size() : 0;
+        auto figure = (op == Workload_Op::add) ? generator.next() : nullptr;
+
+        auto op_start = Clock::now();
+        switch (op) {
+            case Workload_Op::add: figures.add_figure(std::move(figure)); break;
+            case Workload_Op::remove: figures.remove_figure(index); break;
+            case Workload_Op::index: sink += figures[index]->square(); break;
+            case Workload_Op::total_area: sink += figures.total_square(); break;
+            case Workload_Op::print: print_sink << *figures[index]; break;
+        }
+        auto elapsed = std::chrono::duration<double, std::nano>(Clock::now() - op_start).count();
+
+        auto& stats = report.ops[static_cast<size_t>(op)];
+        ++stats.count;
+        stats.latency_ns.add(elapsed);
+    }
+    report.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    report.operations = options.operations;
+    report.figures = figures.get_size();
+    report.peak_rss_kb = peak_rss_kb();
+    if (sink < 0) {
+        print_sink << sink;  // не даём компилятору выбросить вычисления
+    }
+    return report;
+}
+
+inline void print_workload_report(std::ostream& os, const Workload_Report& report) {
+    os << "figures: " << report.figures
+       << ", fill: " << report.fill_seconds << " s" << '\n'
+       << "operations: " << report.operations
+       << ", time: " << report.seconds << " s"
+       << ", throughput: " << report.throughput() << " ops/s" << '\n';
+    os << std::left << std::setw(12) << "op" << std::right
+       << std::setw(10) << "count"
+       << std::setw(12) << "p50_ns"
+       << std::setw(12) << "p90_ns"
+       << std::setw(12) << "p99_ns" << '\n';
+    for (size_t k = 0; k < workload_op_count; ++k) {
+        const Op_Report& op = report.ops[k];
+        if (op.count == 0) continue;
+        os << std::left << std::setw(12) << workload_op_names[k] << std::right
+           << std::setw(10) << op.count
+           << std::setw(12) << op.latency_ns.quantile(0.5)
+           << std::setw(12) << op.latency_ns.quantile(0.9)
+           << std::setw(12) << op.latency_ns.quantile(0.99) << '\n';
+    }
+    os << "peak RSS: " << report.peak_rss_kb << " KiB" << '\n';
+}
@@ -0,0 +1,144 @@
+// Замена operator new/delete ниже работает через malloc/free. GCC при встраивании
+// принимает такие пары за несогласованные (-Wmismatched-new-delete), хотя они парные.
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <memory>
+
+#include "point.h"
+#include "triangle.h"
+#include "hexagon.h"
+#include "octagon.h"
+#include "figures_array.h"
+#include "figure.h"
+
+// ===========================
+//   Подсчёт выделений памяти
+// ===========================
+
+static std::atomic<std::size_t> allocation_count{0};
+
+void* operator new(std::size_t size) {
+    ++allocation_count;
+    if (void* p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+// Сколько раз вызывался operator new во время выполнения f
+template<typename F>
+std::size_t allocations_during(F&& f) {
+    std::size_t before = allocation_count.load();
+    f();
+    return allocation_count.load() - before;
+}
+
+using FigurePtr = std::shared_ptr<Figure<double>>;
+
+static FigurePtr make_triangle() {
+    return std::make_shared<Triangle<double>>(Point<double>(0,0), Point<double>(4,0), Point<double>(0,3));
+}
+
+static FigurePtr make_hexagon() {
+    return std::make_shared<Hexagon<double>>(
+        Point<double>(0,0), Point<double>(2,0), Point<double>(3,1),
+        Point<double>(2,2), Point<double>(0,2), Point<double>(-1,1));
+}
+
+static FigurePtr make_octagon() {
+    return std::make_shared<Octagon<double>>(
+        Point<double>(0,0), Point<double>(1,0), Point<double>(2,1), Point<double>(2,2),
+        Point<double>(1,3), Point<double>(0,3), Point<double>(-1,2), Point<double>(-1,1));
+}
+
+// ======================
+//   Метрики фигур
+// ======================
+
+TEST(AllocationBudget, SquareAndPerimeterDoNotAllocate) {
+    FigurePtr figures[] = {make_triangle(), make_hexagon(), make_octagon()};
+    for (const auto& f : figures) {
+        double sink = 0;
+        EXPECT_EQ(allocations_during([&] {
+            sink += f->square();
+            sink += f->perimeter();
+            sink += static_cast<double>(*f);
+        }), 0u);
+        EXPECT_GT(sink, 0.0);
+    }
+}
+
+TEST(AllocationBudget, CenterDoesNotAllocate) {
+    FigurePtr figures[] = {make_triangle(), make_hexagon(), make_octagon()};
+    for (const auto& f : figures) {
+        Point<double> c;
+        EXPECT_EQ(allocations_during([&] { c = f->center(); }), 0u);
+        auto legacy = f->geometric_center();
+        EXPECT_DOUBLE_EQ(c.get_x(), legacy->get_x());
+        EXPECT_DOUBLE_EQ(c.get_y(), legacy->get_y());
+    }
+}
+
+TEST(AllocationBudget, MetricsDoNotAllocate) {
+    FigurePtr figures[] = {make_triangle(), make_hexagon(), make_octagon()};
+    for (const auto& f : figures) {
+        Figure_Metrics m;
+        EXPECT_EQ(allocations_during([&] { m = f->metrics(); }), 0u);
+        EXPECT_GT(m.area, 0.0);
+    }
+}
+
+// ===========================
+//   Array_Of_Figures
+// ===========================
+
+TEST(AllocationBudget, AddWithinCapacityDoesNotAllocate) {
+    Array_Of_Figures<FigurePtr> arr(4);
+    auto tri = make_triangle();
+    EXPECT_EQ(allocations_during([&] {
+        for (size_t i = 0; i < arr.get_capacity(); ++i) {
+            arr.add_figure(tri);
+        }
+    }), 0u);
+}
+
+TEST(AllocationBudget, AddFigureIsBoundedPerCall) {
+    Array_Of_Figures<FigurePtr> arr(1);
+    auto tri = make_triangle();
+    std::size_t total = 0;
+    for (int i = 0; i < 1024; ++i) {
+        std::size_t n = allocations_during([&] { arr.add_figure(tri); });
+        EXPECT_LE(n, 1u);
+        total += n;
+    }
+    // Ёмкость удваивается — выделений не больше логарифма от числа вставок
+    EXPECT_LE(total, 11u);
+}
+
+TEST(AllocationBudget, RemoveAndTotalSquareDoNotAllocate) {
+    Array_Of_Figures<FigurePtr> arr(4);
+    arr.add_figure(make_triangle());
+    arr.add_figure(make_hexagon());
+    arr.add_figure(make_octagon());
+    double total = 0;
+    EXPECT_EQ(allocations_during([&] {
+        total = arr.total_square();
+        arr.remove_figure(0);
+    }), 0u);
+    EXPECT_GT(total, 0.0);
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -6,6 +6,34 @@
 #include "octagon.h"
 #include "figures_array.h"
 #include "figure.h"
+#include "overlap.h"
+#include "figure_io.h"
+#include "figure_stream.h"
+#include "spsc_queue.h"
+#include "figure_loader.h"
+#include "figure_stats.h"
+#include "figure_journal.h"
+#include "figure_generator.h"
+#include "workload.h"
+#include "shared_figure_store.h"
+#include "figure_clipping.h"
+
+#include <algorithm>
+#include <chrono>
+#include <csignal>
+#include <ctime>
+#include <execution>
+#include <filesystem>
+#include <numeric>
+#include <ranges>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <utility>
+
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
 
 // ======================
 //   Triangle Tests
@@ -28,6 +56,13 @@ TEST(TriangleTest, CenterCorrect) {
     EXPECT_DOUBLE_EQ(c->get_y(), 1.0);
 }
 
+TEST(TriangleTest, CenterByValue) {
+    Triangle<double> t({0,0}, {3,0}, {0,3});
+    Point<double> c = t.center();
+    EXPECT_DOUBLE_EQ(c.get_x(), 1.0);
+    EXPECT_DOUBLE_EQ(c.get_y(), 1.0);
+}
+
 // ======================
 //   Hexagon Tests
 // ======================
@@ -249,6 +284,993 @@ TEST(ArrayTest, AddBeyondCapacity) {
 }
 
 
+// ===========================
+//   Поиск пересечений
+// ===========================
+
+TEST(OverlapTest, FindsOverlappingPairs) {
+    Array_Of_Figures<std::shared_ptr<Figure<double>>> arr(4);
+    arr.add_figure(std::make_shared<Triangle<double>>(Point<double>(0,0), Point<double>(4,0), Point<double>(0,4)));
+    arr.add_figure(std::make_shared<Triangle<double>>(Point<double>(1,1), Point<double>(5,1), Point<double>(1,5)));
+    arr.add_figure(std::make_shared<Triangle<double>>(Point<double>(10,10), Point<double>(11,10), Point<double>(10,11)));
+
+    auto pairs = find_overlaps(arr);
+    ASSERT_EQ(pairs.size(), 1u);
+    EXPECT_EQ(pairs[0], (std::pair<size_t, size_t>(0, 1)));
+}
+
+TEST(OverlapTest, BoxesIntersectButPolygonsDoNot) {
+    Array_Of_Figures<std::shared_ptr<Figure<double>>> arr(2);
+    arr.add_figure(std::make_shared<Triangle<double>>(Point<double>(0,0), Point<double>(4,0), Point<double>(0,4)));
+    arr.add_figure(std::make_shared<Triangle<double>>(Point<double>(4,4), Point<double>(4,1), Point<double>(1,4)));
+    EXPECT_TRUE(find_overlaps(arr).empty());
+}
+
+TEST(OverlapTest, TouchingIsNotOverlap) {
+    Array_Of_Figures<std::shared_ptr<Figure<double>>> arr(2);
+    arr.add_figure(std::make_shared<Hexagon<double>>(Point<double>(0,0), Point<double>(2,0), Point<double>(3,1), Point<double>(2,2), Point<double>(0,2), Point<double>(-1,1)));
+    arr.add_figure(std::make_shared<Triangle<double>>(Point<double>(3,1), Point<double>(5,0), Point<double>(5,2)));
+    EXPECT_TRUE(find_overlaps(arr).empty());
+}
+
+TEST(OverlapTest, MatchesBruteForceMultithreaded) {
+    Array_Of_Figures<std::shared_ptr<Figure<double>>> arr(64);
+    for (int i = 0; i < 40; ++i) {
+        for (int j = 0; j < 40; ++j) {
+            double x = i * 1.5, y = j * 1.5 + (i % 3) * 0.4;
+            arr.add_figure(std::make_shared<Octagon<double>>(
+                Point<double>(x, y), Point<double>(x+1, y), Point<double>(x+2, y+1), Point<double>(x+2, y+2),
+                Point<double>(x+1, y+3), Point<double>(x, y+3), Point<double>(x-1, y+2), Point<double>(x-1, y+1)));
+        }
+    }
+    Flat_Polygons polys = flatten_figures(arr);
+    std::vector<std::pair<size_t, size_t>> expected;
+    for (size_t a = 0; a < polys.size(); ++a)
+        for (size_t b = a + 1; b < polys.size(); ++b)
+            if (convex_polygons_overlap(polys, a, b)) expected.emplace_back(a, b);
+
+    EXPECT_FALSE(expected.empty());
+    EXPECT_EQ(find_overlaps(arr, 1), expected);
+    EXPECT_EQ(find_overlaps(arr, 4), expected);
+}
+
+
+// ===========================
+//   Потоковая обработка
+// ===========================
+
+TEST(StreamTest, ReadFigureByName) {
+    std::istringstream in("hexagon (0,0) (2,0) (3,1) (2,2) (0,2) (-1,1)");
+    auto f = read_figure<double>(in);
+    ASSERT_NE(f, nullptr);
+    EXPECT_NEAR(f->square(), 6.0, 1e-9);
+    EXPECT_EQ(read_figure<double>(in), nullptr);
+}
+
+TEST(StreamTest, UnknownFigureThrows) {
+    std::istringstream in("pentagon (0,0)");
+    EXPECT_THROW(read_figure<double>(in), std::invalid_argument);
+}
+
+TEST(StreamTest, KeepsInputOrder) {
+    std::ostringstream input, expected;
+    for (int i = 0; i < 500; ++i) {
+        input << "triangle (0,0) (" << i + 1 << ",0) (0,2)\n";
+        Triangle<double> t({0,0}, {double(i + 1),0}, {0,2});
+        expected << "triangle center: " << t.center() << " area: " << t.square()
+                 << " perimeter: " << t.perimeter() << '\n';
+    }
+    std::istringstream in(input.str());
+    std::ostringstream out;
+    EXPECT_EQ(stream_figures<double>(in, out, 3, 8), 500u);
+    EXPECT_EQ(out.str(), expected.str());
+}
+
+TEST(StreamTest, MalformedInputReported) {
+    std::istringstream in("triangle (0,0) (1,0) (0,1)\ntriangle (0,0) oops");
+    std::ostringstream out;
+    EXPECT_THROW(stream_figures<double>(in, out, 2), std::invalid_argument);
+    EXPECT_NE(out.str().find("triangle center"), std::string::npos);
+}
+
+// Процессорное время текущего потока в секундах
+static double thread_cpu_seconds() {
+    timespec ts{};
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+TEST(SpscQueueTest, IdleConsumerSleeps) {
+    Spsc_Queue<int> queue(4);
+    double consumer_cpu = 0;
+    int received = 0;
+    std::thread consumer([&] {
+        double start = thread_cpu_seconds();
+        received = queue.pop();
+        consumer_cpu = thread_cpu_seconds() - start;
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    queue.push(42);
+    consumer.join();
+    EXPECT_EQ(received, 42);
+    EXPECT_LT(consumer_cpu, 0.05);
+}
+
+TEST(SpscQueueTest, FullQueueProducerSleeps) {
+    Spsc_Queue<int> queue(2);
+    double producer_cpu = 0;
+    std::thread producer([&] {
+        double start = thread_cpu_seconds();
+        for (int i = 0; i < 3; ++i) queue.push(int{i});
+        producer_cpu = thread_cpu_seconds() - start;
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    EXPECT_EQ(queue.pop(), 0);
+    producer.join();
+    EXPECT_EQ(queue.pop(), 1);
+    EXPECT_EQ(queue.pop(), 2);
+    EXPECT_LT(producer_cpu, 0.05);
+}
+
+TEST(SpscQueueTest, TransfersInOrderUnderContention) {
+    Spsc_Queue<int> queue(8);
+    const int count = 200000;
+    std::thread producer([&] {
+        for (int i = 0; i < count; ++i) queue.push(int{i});
+    });
+    bool ordered = true;
+    for (int i = 0; i < count; ++i) {
+        ordered = ordered && queue.pop() == i;
+    }
+    producer.join();
+    EXPECT_TRUE(ordered);
+}
+
+// ===========================
+//   Загрузка из файла
+// ===========================
+
+TEST(LoaderTest, SplitAtLineBoundaries) {
+    std::string text = "aaaa\nbb\ncccccc\nd\n";
+    auto bounds = split_records(text.data(), text.size(), 3);
+    ASSERT_EQ(bounds.size(), 4u);
+    EXPECT_EQ(bounds.front(), 0u);
+    EXPECT_EQ(bounds.back(), text.size());
+    for (size_t k = 1; k + 1 < bounds.size(); ++k) {
+        EXPECT_EQ(text[bounds[k] - 1], '\n');
+    }
+}
+
+TEST(LoaderTest, ParallelLoadKeepsFileOrder) {
+    auto path = std::filesystem::temp_directory_path() / "lab4_loader_test.txt";
+    {
+        std::ofstream out(path);
+        for (int i = 0; i < 20000; ++i) {
+            if (i % 2 == 0) out << "triangle (0,0) (" << i + 1 << ",0) (0,2)\n";
+            else out << "hexagon (0,0) (2,0) (3,1) (2,2) (0,2) (-1," << i << ")\n";
+        }
+    }
+    auto arr = load_figures<double>(path.string(), 4);
+    std::filesystem::remove(path);
+
+    ASSERT_EQ(arr.get_size(), 20000u);
+    EXPECT_DOUBLE_EQ(arr[0]->square(), 1.0);
+    EXPECT_DOUBLE_EQ(arr[9998]->square(), 9999.0);
+    EXPECT_EQ(arr[19999]->vertex(5).get_y(), 19999.0);
+}
+
+TEST(LoaderTest, MissingFileThrows) {
+    EXPECT_THROW(load_figures<double>("/nonexistent/figures.txt"), std::runtime_error);
+}
+
+// ===========================
+//   Поиск дубликатов
+// ===========================
+
+TEST(HashTest, InvariantToStartingVertex) {
+    Hexagon<double> h1({0,0},{2,0},{3,1},{2,2},{0,2},{-1,1});
+    Hexagon<double> h2({2,2},{0,2},{-1,1},{0,0},{2,0},{3,1});
+    EXPECT_EQ(geometry_hash(h1), geometry_hash(h2));
+    EXPECT_TRUE(same_geometry(h1, h2));
+}
+
+TEST(HashTest, SameAreaDifferentVertices) {
+    Triangle<double> t1({0,0},{4,0},{0,3});
+    Triangle<double> t2({1,1},{5,1},{1,4});
+    EXPECT_TRUE(t1 == t2);
+    EXPECT_FALSE(same_geometry(t1, t2));
+}
+
+TEST(HashTest, ToleranceQuantizes) {
+    Triangle<double> t1({0,0},{4,0},{0,3});
+    Triangle<double> t2({0.001,0},{4,0},{0,3});
+    EXPECT_FALSE(same_geometry(t1, t2));
+    EXPECT_TRUE(same_geometry(t1, t2, 0.1));
+}
+
+TEST(HashTest, LargeCoordinatesStayDistinct) {
+    Triangle<double> a({1e10,1e10},{2e10,1e10},{1e10,2e10});
+    Triangle<double> b({3e10,5e10},{7e10,4e10},{5e10,9e10});
+    EXPECT_FALSE(same_geometry(a, b));
+    EXPECT_NE(geometry_hash(a), geometry_hash(b));
+    EXPECT_TRUE(same_geometry(a, Triangle<double>({2e10,1e10},{1e10,2e10},{1e10,1e10})));
+
+    Array_Of_Figures<std::shared_ptr<Figure<double>>> arr(2);
+    arr.add_figure(std::make_shared<Triangle<double>>(a));
+    arr.add_figure(std::make_shared<Triangle<double>>(b));
+    EXPECT_EQ(arr.deduplicate(), 0u);
+    EXPECT_EQ(arr.get_size(), 2u);
+    EXPECT_EQ(arr.find_equal(b), (std::vector<size_t>{1}));
+}
+
+TEST(HashTest, InvalidToleranceThrows) {
+    Triangle<double> t({0,0},{4,0},{0,3});
+    EXPECT_THROW(geometry_hash(t, 0.0), std::invalid_argument);
+    EXPECT_THROW(same_geometry(t, t, -1.0), std::invalid_argument);
+}
+
+TEST(ArrayTest, FindEqualAndDeduplicate) {
+    Array_Of_Figures<std::shared_ptr<Figure<double>>> arr(4);
+    arr.add_figure(std::make_shared<Triangle<double>>(Point<double>(0,0), Point<double>(4,0), Point<double>(0,3)));
+    arr.add_figure(std::make_shared<Triangle<double>>(Point<double>(1,1), Point<double>(5,1), Point<double>(1,4)));
+    arr.add_figure(std::make_shared<Triangle<double>>(Point<double>(4,0), Point<double>(0,3), Point<double>(0,0)));
+    arr.add_figure(std::make_shared<Octagon<double>>(Point<double>(0,0), Point<double>(1,0), Point<double>(2,1), Point<double>(2,2), Point<double>(1,3), Point<double>(0,3), Point<double>(-1,2), Point<double>(-1,1)));
+    arr.add_figure(std::make_shared<Triangle<double>>(Point<double>(0,3), Point<double>(0,0), Point<double>(4,0)));
+
+    Triangle<double> probe({0,0},{4,0},{0,3});
+    EXPECT_EQ(arr.find_equal(probe), (std::vector<size_t>{0, 2, 4}));
+
+    EXPECT_EQ(arr.deduplicate(), 2u);
+    ASSERT_EQ(arr.get_size(), 3u);
+    EXPECT_EQ(arr[1]->vertex(0).get_x(), 1.0);
+    EXPECT_EQ(arr[2]->vertex_count(), 8u);
+}
+
+TEST(ArrayTest, FindEqualFollowsChanges) {
+    Array_Of_Figures<std::shared_ptr<Figure<double>>> arr(4);
+    arr.add_figure(std::make_shared<Triangle<double>>(Point<double>(0,0), Point<double>(4,0), Point<double>(0,3)));
+    arr.add_figure(std::make_shared<Triangle<double>>(Point<double>(1,1), Point<double>(5,1), Point<double>(1,4)));
+    arr.add_figure(std::make_shared<Triangle<double>>(Point<double>(4,0), Point<double>(0,3), Point<double>(0,0)));
+    Triangle<double> probe({0,0},{4,0},{0,3});
+    EXPECT_EQ(arr.find_equal(probe), (std::vector<size_t>{0, 2}));
+
+    // Вершины изменились в обход массива
+    std::as_const(arr)[1]->set_vertex(0, Point<double>(0, 0));
+    std::as_const(arr)[1]->set_vertex(1, Point<double>(4, 0));
+    std::as_const(arr)[1]->set_vertex(2, Point<double>(0, 3));
+    arr.refresh_caches();
+    EXPECT_EQ(arr.find_equal(probe), (std::vector<size_t>{0, 1, 2}));
+
+    // Замена через массив видна без refresh_caches()
+    arr[2] = std::make_shared<Triangle<double>>(Point<double>(9,9), Point<double>(10,9), Point<double>(9,10));
+    EXPECT_EQ(arr.find_equal(probe), (std::vector<size_t>{0, 1}));
+    arr.add_figure(std::make_shared<Triangle<double>>(Point<double>(0,3), Point<double>(0,0), Point<double>(4,0)));
+    EXPECT_EQ(arr.find_equal(probe), (std::vector<size_t>{0, 1, 3}));
+    arr.remove_figure(2);
+
+    arr.remove_figure(0);
+    EXPECT_EQ(arr.find_equal(probe), (std::vector<size_t>{0, 1}));
+
+    Triangle<double> near({0.001,0},{4,0},{0,3});
+    EXPECT_TRUE(arr.find_equal(near).empty());
+    EXPECT_EQ(arr.find_equal(near, 0.1), (std::vector<size_t>{0, 1}));
+}
+
+// ===========================
+//   Тип фигуры
+// ===========================
+
+TEST(KindTest, TagAndName) {
+    Hexagon<double> h({0,0},{2,0},{3,1},{2,2},{0,2},{-1,1});
+    EXPECT_EQ(h.get_kind(), Figure_Kind::hexagon);
+    EXPECT_EQ(h.get_name(), "hexagon");
+
+    Hexagon<double> moved(std::move(h));
+    EXPECT_EQ(moved.get_kind(), Figure_Kind::hexagon);
+    EXPECT_EQ(Octagon<double>().clone()->get_name(), "octagon");
+    EXPECT_EQ(kind_from_name("triangle"), Figure_Kind::triangle);
+    EXPECT_FALSE(kind_from_name("circle").has_value());
+}
+
+TEST(KindTest, CompactHeader) {
+    // vptr + однобайтовый тег вместо std::string
+    EXPECT_LE(sizeof(Figure<double>), 2 * sizeof(void*));
+}
+
+TEST(KindTest, PrintUsesName) {
+    Triangle<double> t({0,0},{1,0},{0,1});
+    std::ostringstream out;
+    out << t;
+    EXPECT_EQ(out.str().rfind("triangle:\n", 0), 0u);
+}
+
+TEST(ArrayTest, FilterAndGroupByKind) {
+    Array_Of_Figures<std::shared_ptr<Figure<double>>> arr(4);
+    arr.add_figure(std::make_shared<Triangle<double>>(Point<double>(0,0), Point<double>(1,0), Point<double>(0,1)));
+    arr.add_figure(std::make_shared<Octagon<double>>(Point<double>(0,0), Point<double>(1,0), Point<double>(2,1), Point<double>(2,2), Point<double>(1,3), Point<double>(0,3), Point<double>(-1,2), Point<double>(-1,1)));
+    arr.add_figure(std::make_shared<Triangle<double>>(Point<double>(0,0), Point<double>(4,0), Point<double>(0,3)));
+
+    auto triangles = arr.filter_by_kind(Figure_Kind::triangle);
+    ASSERT_EQ(triangles.get_size(), 2u);
+    EXPECT_DOUBLE_EQ(triangles[1]->square(), 6.0);
+    EXPECT_EQ(arr.filter_by_kind(Figure_Kind::hexagon).get_size(), 0u);
+
+    auto groups = arr.group_by_kind();
+    EXPECT_EQ(groups[static_cast<size_t>(Figure_Kind::triangle)].get_size(), 2u);
+    EXPECT_EQ(groups[static_cast<size_t>(Figure_Kind::hexagon)].get_size(), 0u);
+    EXPECT_EQ(groups[static_cast<size_t>(Figure_Kind::octagon)].get_size(), 1u);
+    EXPECT_EQ(groups[static_cast<size_t>(Figure_Kind::octagon)][0], arr[1]);
+}
+
+// ===========================
+//   Статистика
+// ===========================
+
+TEST(StatsTest, QuantileSketchRelativeError) {
+    Quantile_Sketch sketch(0.01);
+    for (int i = 1; i <= 10000; ++i) sketch.add(i);
+    EXPECT_NEAR(sketch.quantile(0.5), 5000.0, 5000.0 * 0.01);
+    EXPECT_NEAR(sketch.quantile(0.99), 9900.0, 9900.0 * 0.01);
+    EXPECT_LT(sketch.bucket_count(), 500u);
+}
+
+TEST(StatsTest, GroupedSinglePass) {
+    Array_Of_Figures<std::shared_ptr<Figure<double>>> arr(4);
+    arr.add_figure(std::make_shared<Triangle<double>>(Point<double>(0,0), Point<double>(4,0), Point<double>(0,3)));  // 6
+    arr.add_figure(std::make_shared<Triangle<double>>(Point<double>(0,0), Point<double>(2,0), Point<double>(0,2)));  // 2
+    arr.add_figure(std::make_shared<Hexagon<double>>(Point<double>(0,0), Point<double>(2,0), Point<double>(3,1), Point<double>(2,2), Point<double>(0,2), Point<double>(-1,1)));  // 6
+
+    Statistics_Options options;
+    options.area_bin_width = 4.0;
+    options.area_bins = 3;
+    auto stats = compute_statistics(arr, options);
+
+    const auto& tri = stats.of(Figure_Kind::triangle);
+    EXPECT_EQ(tri.count, 2u);
+    EXPECT_DOUBLE_EQ(tri.area.min, 2.0);
+    EXPECT_DOUBLE_EQ(tri.area.max, 6.0);
+    EXPECT_DOUBLE_EQ(tri.area.mean(), 4.0);
+    EXPECT_EQ(tri.area_histogram, (std::vector<size_t>{1, 1, 0}));
+
+    EXPECT_EQ(stats.of(Figure_Kind::octagon).count, 0u);
+    EXPECT_EQ(stats.overall.count, 3u);
+    EXPECT_DOUBLE_EQ(stats.overall.area.sum, arr.total_square());
+    EXPECT_NEAR(stats.of(Figure_Kind::hexagon).center_mean().get_x(), 1.0, 1e-9);
+}
+
+TEST(StatsTest, ParallelMatchesSequential) {
+    Array_Of_Figures<std::shared_ptr<Figure<double>>> arr(1024);
+    for (int i = 0; i < 20000; ++i) {
+        double k = 1 + i % 50;
+        if (i % 3 == 0) arr.add_figure(std::make_shared<Triangle<double>>(Point<double>(i,0), Point<double>(i+k,0), Point<double>(i,k)));
+        else arr.add_figure(std::make_shared<Hexagon<double>>(Point<double>(0,i), Point<double>(k,i), Point<double>(k+1,i+1), Point<double>(k,i+2), Point<double>(0,i+2), Point<double>(-1,i+1)));
+    }
+    Statistics_Options seq, par;
+    seq.threads = 1;
+    par.threads = 4;
+    auto a = compute_statistics(arr, seq);
+    auto b = compute_statistics(arr, par);
+    EXPECT_EQ(a.overall.count, b.overall.count);
+    EXPECT_NEAR(a.overall.perimeter.sum, b.overall.perimeter.sum, 1e-6);
+    EXPECT_DOUBLE_EQ(a.overall.area.quantile(0.9), b.overall.area.quantile(0.9));
+    EXPECT_EQ(a.of(Figure_Kind::hexagon).area_histogram, b.of(Figure_Kind::hexagon).area_histogram);
+    EXPECT_NEAR(a.overall.center_stddev().get_y(), b.overall.center_stddev().get_y(), 1e-6);
+}
+
+// ===========================
+//   Метрики за один проход
+// ===========================
+
+TEST(MetricsTest, MatchesSeparateCalls) {
+    std::shared_ptr<Figure<double>> figures[] = {
+        std::make_shared<Triangle<double>>(Point<double>(0,0), Point<double>(4,0), Point<double>(0,3)),
+        std::make_shared<Hexagon<double>>(Point<double>(0,0), Point<double>(2,0), Point<double>(3,1), Point<double>(2,2), Point<double>(0,2), Point<double>(-1,1)),
+        std::make_shared<Octagon<double>>(Point<double>(0,0), Point<double>(1,0), Point<double>(2,1), Point<double>(2,2), Point<double>(1,3), Point<double>(0,3), Point<double>(-1,2), Point<double>(-1,1)),
+    };
+    for (const auto& f : figures) {
+        Figure_Metrics m = f->metrics();
+        EXPECT_NEAR(m.area, f->square(), 1e-9);
+        EXPECT_NEAR(m.perimeter, f->perimeter(), 1e-9);
+        EXPECT_NEAR(m.center.get_x(), f->center().get_x(), 1e-9);
+        EXPECT_NEAR(m.center.get_y(), f->center().get_y(), 1e-9);
+    }
+}
+
+TEST(MetricsTest, CentroidAndBounds) {
+    // Треугольник: центр масс совпадает со средним вершин
+    Triangle<double> t({0,0},{3,0},{0,3});
+    Figure_Metrics m = t.metrics();
+    EXPECT_NEAR(m.centroid.get_x(), 1.0, 1e-9);
+    EXPECT_NEAR(m.centroid.get_y(), 1.0, 1e-9);
+    EXPECT_DOUBLE_EQ(m.bounds.max_x, 3.0);
+    EXPECT_DOUBLE_EQ(m.bounds.min_y, 0.0);
+
+    // Несимметричный шестиугольник: центр масс отличается от среднего вершин
+    Hexagon<double> h({0,0},{4,0},{4,1},{4,2},{4,3},{0,3});
+    Figure_Metrics hm = h.metrics();
+    EXPECT_NEAR(hm.centroid.get_x(), 2.0, 1e-9);
+    EXPECT_NEAR(hm.centroid.get_y(), 1.5, 1e-9);
+    EXPECT_NEAR(hm.center.get_x(), 8.0 / 3.0, 1e-9);
+}
+
+TEST(ArrayTest, BatchMetricsAndReport) {
+    Array_Of_Figures<std::shared_ptr<Figure<double>>> arr(2);
+    arr.add_figure(std::make_shared<Triangle<double>>(Point<double>(0,0), Point<double>(4,0), Point<double>(0,3)));
+    arr.add_figure(std::make_shared<Triangle<double>>(Point<double>(0,0), Point<double>(2,0), Point<double>(0,2)));
+
+    auto all = arr.metrics();
+    ASSERT_EQ(all.size(), 2u);
+    EXPECT_DOUBLE_EQ(all[0].area + all[1].area, arr.total_square());
+
+    std::ostringstream out;
+    arr.print_report(out);
+    EXPECT_EQ(out.str(), "triangle center: (1.33333, 1) area: 6 perimeter: 12\n"
+                         "triangle center: (0.666667, 0.666667) area: 2 perimeter: 6.82843\n");
+}
+
+// ===========================
+//   Журнал и снимки
+// ===========================
+
+static std::filesystem::path fresh_journal_dir(const std::string& name) {
+    auto dir = std::filesystem::temp_directory_path() / name;
+    std::filesystem::remove_all(dir);
+    return dir;
+}
+
+TEST(JournalTest, RestoresAfterRestart) {
+    auto dir = fresh_journal_dir("lab4_journal_restore");
+    {
+        Figure_Journal<double> journal(dir.string());
+        journal.add_figure(std::make_shared<Triangle<double>>(Point<double>(0,0), Point<double>(4,0), Point<double>(0,3)));
+        journal.add_figure(std::make_shared<Hexagon<double>>(Point<double>(0,0), Point<double>(2,0), Point<double>(3,1), Point<double>(2,2), Point<double>(0,2), Point<double>(-1,1)));
+        journal.add_figure(std::make_shared<Triangle<double>>(Point<double>(0,0), Point<double>(2,0), Point<double>(0,2)));
+        journal.remove_figure(0);
+    }
+    Figure_Journal<double> restored(dir.string());
+    const auto& figures = restored.get_figures();
+    ASSERT_EQ(figures.get_size(), 2u);
+    EXPECT_EQ(figures[0]->get_kind(), Figure_Kind::hexagon);
+    EXPECT_DOUBLE_EQ(figures[0]->square(), 6.0);
+    EXPECT_DOUBLE_EQ(figures[1]->square(), 2.0);
+    EXPECT_EQ(restored.get_log_records(), 4u);
+    std::filesystem::remove_all(dir);
+}
+
+TEST(JournalTest, TornTailIsDropped) {
+    auto dir = fresh_journal_dir("lab4_journal_torn");
+    {
+        Figure_Journal<double> journal(dir.string());
+        journal.add_figure(std::make_shared<Triangle<double>>(Point<double>(0,0), Point<double>(4,0), Point<double>(0,3)));
+    }
+    {
+        // Длина обещает 32 байта, дальше контрольная сумма и короткое тело
+        const char torn[] = "\x20\x00\x00\x00\x01\x02\x03\x04garbage";
+        std::ofstream log(dir / "journal.log", std::ios::binary | std::ios::app);
+        log.write(torn, sizeof torn - 1);
+    }
+    {
+        Figure_Journal<double> journal(dir.string());
+        EXPECT_EQ(journal.get_figures().get_size(), 1u);
+        journal.add_figure(std::make_shared<Triangle<double>>(Point<double>(0,0), Point<double>(2,0), Point<double>(0,2)));
+    }
+    Figure_Journal<double> restored(dir.string());
+    EXPECT_EQ(restored.get_figures().get_size(), 2u);
+    EXPECT_DOUBLE_EQ(restored.get_figures().total_square(), 8.0);
+    std::filesystem::remove_all(dir);
+}
+
+TEST(JournalTest, ChecksumMismatchIsDropped) {
+    auto dir = fresh_journal_dir("lab4_journal_checksum");
+    {
+        Figure_Journal<double> journal(dir.string());
+        journal.add_figure(std::make_shared<Triangle<double>>(Point<double>(0,0), Point<double>(4,0), Point<double>(0,3)));
+    }
+    {
+        // Целая запись добавления треугольника, но с неверной контрольной суммой
+        std::vector<char> payload{1, static_cast<char>(Figure_Kind::triangle), 3};
+        for (double v : {0.0, 0.0, 1.0, 0.0, 0.0, 1.0}) {
+            const char* bytes = reinterpret_cast<const char*>(&v);
+            payload.insert(payload.end(), bytes, bytes + sizeof v);
+        }
+        std::uint32_t length = static_cast<std::uint32_t>(payload.size()), checksum = 0xDEADBEEF;
+        std::ofstream log(dir / "journal.log", std::ios::binary | std::ios::app);
+        log.write(reinterpret_cast<const char*>(&length), sizeof length);
+        log.write(reinterpret_cast<const char*>(&checksum), sizeof checksum);
+        log.write(payload.data(), static_cast<std::streamsize>(payload.size()));
+    }
+    {
+        Figure_Journal<double> journal(dir.string());
+        EXPECT_EQ(journal.get_figures().get_size(), 1u);
+        EXPECT_EQ(journal.get_log_records(), 1u);
+        journal.add_figure(std::make_shared<Triangle<double>>(Point<double>(0,0), Point<double>(2,0), Point<double>(0,2)));
+    }
+    Figure_Journal<double> restored(dir.string());
+    EXPECT_EQ(restored.get_figures().get_size(), 2u);
+    EXPECT_DOUBLE_EQ(restored.get_figures().total_square(), 8.0);
+    std::filesystem::remove_all(dir);
+}
+
+TEST(JournalTest, KeepsOwnCopyOfFigures) {
+    auto dir = fresh_journal_dir("lab4_journal_copy");
+    auto figure = std::make_shared<Triangle<double>>(Point<double>(0,0), Point<double>(4,0), Point<double>(0,3));
+    {
+        Figure_Journal<double> journal(dir.string());
+        journal.add_figure(figure);
+        figure->set_vertex(1, Point<double>(100, 0));
+        static_assert(std::is_const_v<std::remove_reference_t<decltype(*journal.get_figures()[0])>>);
+        EXPECT_DOUBLE_EQ(journal.get_figures().total_square(), 6.0);
+        journal.snapshot();
+    }
+    Figure_Journal<double> restored(dir.string());
+    EXPECT_DOUBLE_EQ(restored.get_figures().total_square(), 6.0);
+    std::filesystem::remove_all(dir);
+}
+
+TEST(JournalTest, FailedCommitIsTruncatedBeforeRetry) {
+    auto dir = fresh_journal_dir("lab4_journal_retry");
+    // Ограничение размера файла действует на весь процесс — проверяем в дочернем
+    pid_t child = fork();
+    ASSERT_GE(child, 0);
+    if (child == 0) {
+        std::signal(SIGXFSZ, SIG_IGN);
+        Figure_Journal<double> journal(dir.string());
+        journal.add_figure(std::make_shared<Triangle<double>>(Point<double>(0,0), Point<double>(4,0), Point<double>(0,3)));
+        journal.commit();
+
+        rlimit saved{};
+        getrlimit(RLIMIT_FSIZE, &saved);
+        rlimit small = saved;
+        small.rlim_cur = std::filesystem::file_size(dir / "journal.log") + 10;
+        setrlimit(RLIMIT_FSIZE, &small);
+        journal.add_figure(std::make_shared<Triangle<double>>(Point<double>(0,0), Point<double>(2,0), Point<double>(0,2)));
+        bool failed = false;
+        try {
+            journal.commit();
+        } catch (const std::runtime_error&) {
+            failed = true;
+        }
+        setrlimit(RLIMIT_FSIZE, &saved);
+        journal.commit();
+        _exit(failed ? 0 : 1);
+    }
+    int status = 0;
+    waitpid(child, &status, 0);
+    ASSERT_TRUE(WIFEXITED(status));
+    ASSERT_EQ(WEXITSTATUS(status), 0);
+
+    Figure_Journal<double> restored(dir.string());
+    EXPECT_EQ(restored.get_figures().get_size(), 2u);
+    EXPECT_DOUBLE_EQ(restored.get_figures().total_square(), 8.0);
+    std::filesystem::remove_all(dir);
+}
+
+TEST(JournalTest, PeriodicSnapshotBoundsLog) {
+    auto dir = fresh_journal_dir("lab4_journal_snapshot");
+    Journal_Options options;
+    options.group_size = 4;
+    options.snapshot_min_entries = 10;
+    {
+        Figure_Journal<double> journal(dir.string(), options);
+        for (int i = 0; i < 25; ++i) {
+            journal.add_figure(std::make_shared<Triangle<double>>(Point<double>(0,0), Point<double>(i + 1,0), Point<double>(0,2)));
+        }
+        EXPECT_GT(journal.get_generation(), 0u);
+        EXPECT_LT(journal.get_log_records(), 25u);
+    }
+    Figure_Journal<double> restored(dir.string(), options);
+    ASSERT_EQ(restored.get_figures().get_size(), 25u);
+    EXPECT_DOUBLE_EQ(restored.get_figures()[24]->square(), 25.0);
+    std::filesystem::remove_all(dir);
+}
+
+TEST(JournalTest, StaleLogIgnoredAfterSnapshot) {
+    auto dir = fresh_journal_dir("lab4_journal_stale");
+    {
+        Figure_Journal<double> journal(dir.string());
+        journal.add_figure(std::make_shared<Triangle<double>>(Point<double>(0,0), Point<double>(4,0), Point<double>(0,3)));
+        journal.commit();
+        std::filesystem::copy_file(dir / "journal.log", dir / "old.log");
+        journal.snapshot();
+    }
+    // Сбой между записью снимка и очисткой журнала
+    std::filesystem::rename(dir / "old.log", dir / "journal.log");
+    Figure_Journal<double> restored(dir.string());
+    EXPECT_EQ(restored.get_figures().get_size(), 1u);
+    EXPECT_EQ(restored.get_log_records(), 0u);
+    std::filesystem::remove_all(dir);
+}
+
+// ===========================
+//   Кэш габаритов и отсечение
+// ===========================
+
+TEST(BoundsTest, RevisionChangesOnMutation) {
+    Triangle<double> t({0,0},{1,0},{0,1});
+    auto r0 = t.get_revision();
+    t.set_vertex(1, Point<double>(5, 0));
+    EXPECT_NE(t.get_revision(), r0);
+    auto r1 = t.get_revision();
+    std::istringstream in("(0,0) (1,0) (0,1)");
+    in >> t;
+    EXPECT_NE(t.get_revision(), r1);
+}
+
+TEST(BoundsTest, CullByWindow) {
+    Array_Of_Figures<std::shared_ptr<Figure<double>>> arr(64);
+    for (int i = 0; i < 100; ++i) {
+        arr.add_figure(std::make_shared<Triangle<double>>(Point<double>(i * 10, 0), Point<double>(i * 10 + 2, 0), Point<double>(i * 10, 2)));
+    }
+    Bounding_Box window;
+    window.expand(15, -1);
+    window.expand(41, 1);
+    EXPECT_EQ(arr.cull_by_window(window), (std::vector<size_t>{2, 3, 4}));
+    EXPECT_DOUBLE_EQ(arr.bounds_of(99).max_x, 992.0);
+}
+
+TEST(BoundsTest, CacheFollowsChanges) {
+    Array_Of_Figures<std::shared_ptr<Figure<double>>> arr(4);
+    for (int i = 0; i < 4; ++i) {
+        arr.add_figure(std::make_shared<Triangle<double>>(Point<double>(i * 10, 0), Point<double>(i * 10 + 2, 0), Point<double>(i * 10, 2)));
+    }
+    Bounding_Box window;
+    window.expand(0, 0);
+    window.expand(5, 5);
+    EXPECT_EQ(arr.cull_by_window(window), (std::vector<size_t>{0}));
+
+    // Вершины фигуры изменились в обход массива
+    std::as_const(arr)[3]->set_vertex(0, Point<double>(1, 1));
+    arr.refresh_caches();
+    EXPECT_EQ(arr.cull_by_window(window), (std::vector<size_t>{0, 3}));
+
+    // Фигуру заменили через ссылку
+    arr[1] = std::make_shared<Triangle<double>>(Point<double>(3,3), Point<double>(4,3), Point<double>(3,4));
+    EXPECT_EQ(arr.cull_by_window(window), (std::vector<size_t>{0, 1, 3}));
+
+    // Удаление сдвигает кэш вместе с фигурами
+    arr.remove_figure(0);
+    EXPECT_EQ(arr.cull_by_window(window), (std::vector<size_t>{0, 2}));
+
+    arr.add_figure(std::make_shared<Triangle<double>>(Point<double>(4,4), Point<double>(9,4), Point<double>(4,9)));
+    EXPECT_EQ(arr.cull_by_window(window), (std::vector<size_t>{0, 2, 3}));
+}
+
+TEST(BoundsTest, ReferenceWrittenAfterCullNeedsRefresh) {
+    Array_Of_Figures<std::shared_ptr<Figure<double>>> arr(4);
+    for (int i = 0; i < 3; ++i) {
+        arr.add_figure(std::make_shared<Triangle<double>>(Point<double>(i * 10, 0), Point<double>(i * 10 + 2, 0), Point<double>(i * 10, 2)));
+    }
+    Bounding_Box window;
+    window.expand(0, 0);
+    window.expand(5, 5);
+
+    auto& ref = arr[1];
+    EXPECT_EQ(arr.cull_by_window(window), (std::vector<size_t>{0}));
+    ref = std::make_shared<Triangle<double>>(Point<double>(3,3), Point<double>(4,3), Point<double>(3,4));
+    arr.refresh_caches();
+    EXPECT_EQ(arr.cull_by_window(window), (std::vector<size_t>{0, 1}));
+
+    // Две замены подряд: новая фигура может занять адрес удалённой
+    ref = std::make_shared<Triangle<double>>(Point<double>(30,30), Point<double>(40,30), Point<double>(30,40));
+    ref = std::make_shared<Triangle<double>>(Point<double>(30,30), Point<double>(40,30), Point<double>(30,40));
+    arr.refresh_caches();
+    EXPECT_EQ(arr.cull_by_window(window), (std::vector<size_t>{0}));
+}
+
+TEST(BoundsTest, QueriesDoNotRescanUnchangedArray) {
+    Array_Of_Figures<std::shared_ptr<Figure<double>>> arr(4);
+    arr.add_figure(std::make_shared<Triangle<double>>(Point<double>(0,0), Point<double>(2,0), Point<double>(0,2)));
+    Bounding_Box window;
+    window.expand(0, 0);
+    window.expand(5, 5);
+    EXPECT_EQ(arr.cull_by_window(window), (std::vector<size_t>{0}));
+
+    // Изменение в обход массива без refresh_caches() не видно: запросы читают только кэш
+    std::as_const(arr)[0]->set_vertex(0, Point<double>(100, 100));
+    std::as_const(arr)[0]->set_vertex(1, Point<double>(102, 100));
+    std::as_const(arr)[0]->set_vertex(2, Point<double>(100, 102));
+    EXPECT_EQ(arr.cull_by_window(window), (std::vector<size_t>{0}));
+    EXPECT_DOUBLE_EQ(arr.bounds_of(0).max_x, 2.0);
+    arr.refresh_caches();
+    EXPECT_TRUE(arr.cull_by_window(window).empty());
+    EXPECT_DOUBLE_EQ(arr.bounds_of(0).max_x, 102.0);
+}
+
+TEST(BoundsTest, ConcurrentCullOnConstArray) {
+    Array_Of_Figures<std::shared_ptr<Figure<double>>> arr(512);
+    for (int i = 0; i < 1000; ++i) {
+        arr.add_figure(std::make_shared<Triangle<double>>(Point<double>(i * 10, 0), Point<double>(i * 10 + 2, 0), Point<double>(i * 10, 2)));
+    }
+    const auto& shared = arr;
+    Bounding_Box window;
+    window.expand(15, -1);
+    window.expand(41, 1);
+
+    std::vector<std::vector<size_t>> results(4);
+    std::vector<std::thread> readers;
+    for (size_t t = 0; t < results.size(); ++t) {
+        readers.emplace_back([&, t] { results[t] = shared.cull_by_window(window); });
+    }
+    for (auto& r : readers) r.join();
+    for (const auto& r : results) {
+        EXPECT_EQ(r, (std::vector<size_t>{2, 3, 4}));
+    }
+}
+
+// ===========================
+//   Генератор нагрузки
+// ===========================
+
+TEST(GeneratorTest, DeterministicAndValid) {
+    Figure_Generator<double> g1(42), g2(42);
+    for (int i = 0; i < 100; ++i) {
+        auto a = g1.next();
+        auto b = g2.next();
+        EXPECT_EQ(a->get_kind(), b->get_kind());
+        EXPECT_TRUE(same_geometry(*a, *b));
+        EXPECT_GT(a->square(), 0.0);
+    }
+}
+
+TEST(GeneratorTest, TypeMixRespected) {
+    Figure_Generator<double> g(1, {0.0, 1.0, 0.0});
+    for (int i = 0; i < 50; ++i) {
+        EXPECT_EQ(g.next()->get_kind(), Figure_Kind::hexagon);
+    }
+}
+
+TEST(WorkloadTest, RunsOperationMix) {
+    Workload_Options options;
+    options.figures = 200;
+    options.operations = 1000;
+    options.op_mix = {1.0, 1.0, 1.0, 0.1, 0.5};
+    Null_Streambuf null_buffer;
+    std::ostream sink(&null_buffer);
+    Workload_Report report = run_workload<double>(options, sink);
+
+    size_t total = 0;
+    for (const auto& op : report.ops) total += op.count;
+    EXPECT_EQ(total, 1000u);
+    EXPECT_EQ(report.figures, 200 + report.ops[0].count - report.ops[1].count);
+    EXPECT_GT(report.peak_rss_kb, 0);
+
+    std::ostringstream out;
+    print_workload_report(out, report);
+    EXPECT_NE(out.str().find("throughput"), std::string::npos);
+}
+
+// ===========================
+//   Разделяемая память
+// ===========================
+
+static std::string shared_store_name(const std::string& tag) {
+    return "/lab4_" + tag + "_" + std::to_string(::getpid());
+}
+
+TEST(SharedStoreTest, PublishAndRead) {
+    Array_Of_Figures<std::shared_ptr<Figure<double>>> arr(4);
+    arr.add_figure(std::make_shared<Triangle<double>>(Point<double>(0,0), Point<double>(4,0), Point<double>(0,3)));
+    arr.add_figure(std::make_shared<Hexagon<double>>(Point<double>(0,0), Point<double>(2,0), Point<double>(3,1), Point<double>(2,2), Point<double>(0,2), Point<double>(-1,1)));
+
+    Shared_Figure_Publisher publisher(shared_store_name("read"));
+    EXPECT_EQ(publisher.publish(arr), 1u);
+
+    auto view = Shared_Figure_View::open_latest(shared_store_name("read"));
+    ASSERT_EQ(view.get_size(), 2u);
+    EXPECT_EQ(view.kind(1), Figure_Kind::hexagon);
+    EXPECT_EQ(view.vertex_count(1), 6u);
+    EXPECT_DOUBLE_EQ(view.square(0), 6.0);
+    EXPECT_NEAR(view.perimeter(0), 12.0, 1e-9);
+    EXPECT_DOUBLE_EQ(view.total_square(), arr.total_square());
+    EXPECT_DOUBLE_EQ(view.vertex(1, 2).get_x(), 3.0);
+
+    Bounding_Box window;
+    window.expand(-1.5, 0.5);
+    window.expand(-0.5, 1.5);
+    EXPECT_EQ(view.query(window), (std::vector<size_t>{1}));
+}
+
+TEST(SharedStoreTest, VersionsAndOldReaders) {
+    Array_Of_Figures<std::shared_ptr<Figure<double>>> arr(2);
+    arr.add_figure(std::make_shared<Triangle<double>>(Point<double>(0,0), Point<double>(4,0), Point<double>(0,3)));
+
+    Shared_Figure_Publisher publisher(shared_store_name("versions"));
+    publisher.publish(arr);
+    auto old_view = Shared_Figure_View::open_latest(shared_store_name("versions"));
+
+    arr.add_figure(std::make_shared<Triangle<double>>(Point<double>(0,0), Point<double>(2,0), Point<double>(0,2)));
+    publisher.publish(arr);
+
+    EXPECT_TRUE(old_view.is_stale());
+    EXPECT_EQ(old_view.get_size(), 1u);
+    EXPECT_DOUBLE_EQ(old_view.total_square(), 6.0);
+
+    auto new_view = Shared_Figure_View::open_latest(shared_store_name("versions"));
+    EXPECT_FALSE(new_view.is_stale());
+    EXPECT_EQ(new_view.get_version(), 2u);
+    EXPECT_DOUBLE_EQ(new_view.total_square(), 8.0);
+}
+
+TEST(SharedStoreTest, ReaderInAnotherProcess) {
+    Array_Of_Figures<std::shared_ptr<Figure<double>>> arr(2);
+    arr.add_figure(std::make_shared<Triangle<double>>(Point<double>(0,0), Point<double>(4,0), Point<double>(0,3)));
+    std::string name = shared_store_name("process");
+    Shared_Figure_Publisher publisher(name);
+    publisher.publish(arr);
+
+    pid_t child = ::fork();
+    ASSERT_GE(child, 0);
+    if (child == 0) {
+        int code = 1;
+        try {
+            auto view = Shared_Figure_View::open_latest(name);
+            code = (view.total_square() == 6.0) ? 0 : 2;
+        } catch (...) {
+        }
+        ::_exit(code);
+    }
+    int status = 0;
+    ::waitpid(child, &status, 0);
+    ASSERT_TRUE(WIFEXITED(status));
+    EXPECT_EQ(WEXITSTATUS(status), 0);
+}
+
+TEST(SharedStoreTest, MissingStoreThrows) {
+    EXPECT_THROW(Shared_Figure_View::open_latest("/lab4_missing_store"), std::runtime_error);
+}
+
+// ===========================
+//   Итераторы и алгоритмы
+// ===========================
+
+static Array_Of_Figures<std::shared_ptr<Figure<double>>> make_mixed_array() {
+    Array_Of_Figures<std::shared_ptr<Figure<double>>> arr(4);
+    arr.add_figure(std::make_shared<Triangle<double>>(Point<double>(0,0), Point<double>(4,0), Point<double>(0,3)));   // 6
+    arr.add_figure(std::make_shared<Octagon<double>>(Point<double>(0,0), Point<double>(1,0), Point<double>(2,1), Point<double>(2,2), Point<double>(1,3), Point<double>(0,3), Point<double>(-1,2), Point<double>(-1,1)));  // 7
+    arr.add_figure(std::make_shared<Triangle<double>>(Point<double>(0,0), Point<double>(2,0), Point<double>(0,2)));   // 2
+    return arr;
+}
+
+TEST(IteratorTest, RangeForAndContiguous) {
+    static_assert(std::ranges::contiguous_range<Array_Of_Figures<std::shared_ptr<Figure<double>>>>);
+    auto arr = make_mixed_array();
+    double total = 0;
+    for (const auto& figure : std::as_const(arr)) {
+        total += figure->square();
+    }
+    EXPECT_DOUBLE_EQ(total, arr.total_square());
+    EXPECT_EQ(std::as_const(arr).end() - std::as_const(arr).begin(), 3);
+    EXPECT_EQ(arr.unchecked(2), arr[2]);
+}
+
+TEST(IteratorTest, ViewsByKindAndArea) {
+    auto arr = make_mixed_array();
+    auto triangles = arr.of_kind(Figure_Kind::triangle);
+    EXPECT_EQ(std::ranges::distance(triangles), 2);
+
+    auto areas = arr.areas();
+    EXPECT_DOUBLE_EQ(*std::ranges::max_element(areas), 7.0);
+    EXPECT_DOUBLE_EQ(std::accumulate(areas.begin(), areas.end(), 0.0), 15.0);
+}
+
+TEST(IteratorTest, ParallelAlgorithms) {
+    Array_Of_Figures<std::shared_ptr<Figure<double>>> arr(1024);
+    for (int i = 0; i < 5000; ++i) {
+        double k = 1 + (i * 7919) % 1000;
+        arr.add_figure(std::make_shared<Triangle<double>>(Point<double>(0,0), Point<double>(k,0), Point<double>(0,2)));
+    }
+    auto by_area = [](const auto& a, const auto& b) { return a->square() < b->square(); };
+    std::sort(std::execution::par, arr.begin(), arr.end(), by_area);
+    EXPECT_TRUE(std::is_sorted(arr.begin(), arr.end(), by_area));
+
+    double total = std::transform_reduce(std::execution::par_unseq, std::as_const(arr).begin(), std::as_const(arr).end(),
+                                         0.0, std::plus<>(), [](const auto& f) { return f->square(); });
+    EXPECT_NEAR(total, arr.total_square(), 1e-6);
+
+    auto middle = std::partition(std::execution::par, arr.begin(), arr.end(),
+                                 [](const auto& f) { return f->square() < 500.0; });
+    EXPECT_EQ(middle - arr.begin(), 2495);
+}
+
+TEST(IteratorTest, MutableIterationRefreshesBounds) {
+    auto arr = make_mixed_array();
+    Bounding_Box window;
+    window.expand(3, 0);
+    window.expand(5, 1);
+    EXPECT_EQ(arr.cull_by_window(window), (std::vector<size_t>{0}));
+    std::ranges::reverse(arr);
+    EXPECT_EQ(arr.cull_by_window(window), (std::vector<size_t>{2}));
+}
+
+// ===========================
+//   Пересечения и объединение
+// ===========================
+
+static std::shared_ptr<Figure<double>> make_square_octagon(double x, double y, double side) {
+    // Квадрат, заданный восьмиугольником с вершинами в серединах сторон
+    double h = side / 2;
+    return std::make_shared<Octagon<double>>(
+        Point<double>(x, y), Point<double>(x + h, y), Point<double>(x + side, y), Point<double>(x + side, y + h),
+        Point<double>(x + side, y + side), Point<double>(x + h, y + side), Point<double>(x, y + side), Point<double>(x, y + h));
+}
+
+TEST(ClippingTest, IntersectionOfSquares) {
+    auto a = make_square_octagon(0, 0, 2);
+    auto b = make_square_octagon(1, 1, 2);
+    EXPECT_NEAR(intersection_area(*a, *b), 1.0, 1e-12);
+    EXPECT_NEAR(intersection_area(*b, *a), 1.0, 1e-12);
+    EXPECT_NEAR(intersection_area(*a, *make_square_octagon(2, 0, 2)), 0.0, 1e-12);  // касание
+    EXPECT_NEAR(intersection_area(*a, *make_square_octagon(5, 5, 1)), 0.0, 1e-12);
+}
+
+TEST(ClippingTest, ClockwiseTriangleInsideSquare) {
+    auto square = make_square_octagon(0, 0, 4);
+    Triangle<double> clockwise(Point<double>(1,1), Point<double>(1,3), Point<double>(3,1));
+    EXPECT_NEAR(intersection_area(*square, clockwise), 2.0, 1e-12);
+    EXPECT_NEAR(intersection_area(clockwise, *square), 2.0, 1e-12);
+}
+
+TEST(ClippingTest, PairwiseIntersections) {
+    Array_Of_Figures<std::shared_ptr<Figure<double>>> arr(4);
+    arr.add_figure(make_square_octagon(0, 0, 2));
+    arr.add_figure(make_square_octagon(10, 10, 1));
+    arr.add_figure(make_square_octagon(1, 0, 2));
+    arr.add_figure(make_square_octagon(2, 0, 2));  // касается первого
+    auto pairs = pairwise_intersections(arr);
+    ASSERT_EQ(pairs.size(), 2u);
+    EXPECT_EQ(pairs[0].first, 0u);
+    EXPECT_EQ(pairs[0].second, 2u);
+    EXPECT_NEAR(pairs[0].area, 2.0, 1e-12);
+    EXPECT_EQ(pairs[1].first, 2u);
+    EXPECT_EQ(pairs[1].second, 3u);
+    EXPECT_NEAR(pairs[1].area, 2.0, 1e-12);
+}
+
+TEST(ClippingTest, UnionAreaSimpleCases) {
+    Array_Of_Figures<std::shared_ptr<Figure<double>>> empty;
+    EXPECT_DOUBLE_EQ(union_area(empty), 0.0);
+
+    Array_Of_Figures<std::shared_ptr<Figure<double>>> arr(4);
+    arr.add_figure(make_square_octagon(0, 0, 2));
+    arr.add_figure(make_square_octagon(1, 1, 2));
+    EXPECT_NEAR(union_area(arr), 7.0, 1e-9);
+
+    arr.add_figure(make_square_octagon(0, 0, 2));  // точная копия
+    arr.add_figure(make_square_octagon(2, -2, 2)); // общее ребро и вершина
+    arr.add_figure(std::make_shared<Triangle<double>>(Point<double>(0.5,0.5), Point<double>(0.5,1.5), Point<double>(1.5,0.5)));  // внутри
+    EXPECT_NEAR(union_area(arr), 11.0, 1e-9);
+    EXPECT_NEAR(arr.total_square(), 16.5, 1e-9);
+}
+
+TEST(ClippingTest, UnionOfTwoMatchesInclusionExclusion) {
+    Figure_Generator<double> generator(7, {1.0, 1.0, 1.0}, 5.0, 4.0);
+    for (int k = 0; k < 200; ++k) {
+        Array_Of_Figures<std::shared_ptr<Figure<double>>> arr(2);
+        arr.add_figure(generator.next());
+        arr.add_figure(generator.next());
+        double expected = arr[0]->square() + arr[1]->square() - intersection_area(*arr[0], *arr[1]);
+        EXPECT_NEAR(union_area(arr), expected, 1e-9);
+    }
+}
+
+TEST(ClippingTest, UnionAreaIndependentOfThreads) {
+    Figure_Generator<double> generator(11, {1.0, 1.0, 1.0}, 100.0, 3.0);
+    Array_Of_Figures<std::shared_ptr<Figure<double>>> arr;
+    arr.reserve(8000);
+    for (int i = 0; i < 8000; ++i) arr.add_figure(generator.next());
+
+    double single = union_area(arr, 1);
+    EXPECT_DOUBLE_EQ(union_area(arr, 4), single);
+    EXPECT_LT(single, arr.total_square());
+    EXPECT_GT(single, 0.5 * arr.total_square());
+
+    // Площадь объединения = сумма площадей минус попарные пересечения плюс поправки
+    // высших порядков, поэтому она не меньше оценки через попарные пересечения
+    double pairwise = 0;
+    for (const auto& p : pairwise_intersections(arr, 4)) pairwise += p.area;
+    EXPECT_GE(single + 1e-6, arr.total_square() - pairwise);
+}
+
 
 int main(int argc, char **argv) {
     ::testing::InitGoogleTest(&argc, argv);